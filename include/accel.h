@@ -0,0 +1,88 @@
+/*
+* Scene acceleration structure built once parsing is done.
+* Bounded objects (spheres, cylinders, ...) go into a BVH; infinite planes
+* have no box and are kept in a short list tested for every ray.
+* Object ids are positions in the scene object list, so hit tie-breaking
+* matches a linear scan of that list. objects[id] is the parsed object (cold,
+* read when shading the winner); packed holds its intersection data (hot).
+* boxes[] (per BVH primitive) and bvh_prim[] (object id -> BVH primitive,
+* -1 for planes) are kept after the build so an edited object can be
+* refitted in place by accel_update.
+* Small scenes also get a flat layout (see t_accel_flat) that single rays
+* scan with the batch kernels instead of walking the BVH.
+*/
+#ifndef ACCEL_H
+# define ACCEL_H
+
+# include "bvh.h"
+# include "packed.h"
+# include "packet.h"
+# include "batch.h"
+# ifndef SCENE_HEADER
+#  define SCENE_HEADER "scene.h"
+# endif
+# include SCENE_HEADER
+
+/* Scenes with at most this many bounded objects are scanned flat. */
+# define ACCEL_FLAT_MAX 32
+/* Cylinders left over, fewer than this, skip the batch kernel. */
+# define FLAT_CYL_MIN 2
+
+/*
+* spheres, tris: packed spheres and triangles as SoA (entry = packed slot),
+* with the object id of each entry in sphere_ids / tri_ids.
+* cyls: the bounded cylinders as SoA, object ids in cyl_ids.
+* others: the remaining bounded objects, tested one by one.
+*/
+typedef struct s_accel_flat
+{
+	t_sphere_soa		spheres;
+	t_tri_soa			tris;
+	t_cyl_soa			cyls;
+	int					*sphere_ids;
+	int					*tri_ids;
+	int					*cyl_ids;
+	int					*others;
+	int					other_count;
+	const t_batch_ops	*ops;
+}	t_accel_flat;
+
+typedef struct s_accel
+{
+	t_bvh			bvh;
+	const t_object	**objects;
+	t_packed		packed;
+	int				count;
+	int				*bounded;
+	int				*planes;
+	int				plane_count;
+	t_aabb			*boxes;
+	int				*bvh_prim;
+	t_accel_flat	*flat;
+}	t_accel;
+
+/* World-space box of `obj`; returns 0 for unbounded objects (planes). */
+int		object_bounds(const t_object *obj, t_aabb *out);
+
+/* Build scene->accel from the object list; 0 on success, -1 on ENOMEM. */
+int		scene_build_accel(t_scene *scene);
+void	accel_free(t_accel *accel);
+/* Refresh object `id`'s packed data and BVH boxes after an in-place edit. */
+void	accel_update(t_accel *accel, int id);
+/* Feed every candidate object id along q->r to `leaf`. */
+void	accel_traverse(const t_accel *accel, t_bvh_ray *q, t_bvh_leaf leaf,
+			void *ctx);
+/* Flat layout (accel_flat.c); build is a no-op for big scenes, -1 ENOMEM */
+int		accel_flat_build(t_accel *a);
+void	accel_flat_free(t_accel_flat *f);
+void	accel_flat_update(t_accel *a, int id);
+void	accel_flat_traverse(const t_accel *a, t_bvh_ray *q, t_bvh_leaf leaf,
+			void *ctx);
+/*
+* Packet version: packed objects are tested by the vector kernels, the
+* others through `other` (called with ctx = accel).
+*/
+void	accel_traverse_packet(const t_accel *accel, t_packet *pk,
+			t_packet_leaf other);
+
+#endif
@@ -6,17 +6,45 @@
 #endif
 # include SCENE_HEADER
 # include "ui.h"
+# include "gbuffer.h"
+# include "controls.h"
+
+/*
+* Progressive refinement state: current sample spacing (0 once the frame is
+* complete) and the first tile of that pass not rendered yet.
+* moved_ns: time of the last interactive edit; refinement past the coarse
+* pass waits until input has settled (0: never moved).
+*/
+typedef struct s_progress
+{
+	int			step;
+	int			next_tile;
+	long long	moved_ns;
+}	t_progress;
 
 typedef struct s_app
 {
 	mlx_t			*mlx;
 	mlx_image_t		*image;
 	uint32_t		*framebuffer;
+	t_gbuf_px		*gbuf;
+	int				width;
+	int				height;
 	int				show_normals;
+	int				threads;
+	t_progress		progress;
+	t_selection		sel;
 	t_scene			scene;
 	t_toggle_info	overlay;
 }	t_app;
 
 void	app_on_key(mlx_key_data_t keydata, void *param);
+/* Camera / light / object controls (controls.c) */
+bool	controls_key(t_app *app, keys_t key);
+void	app_on_mouse(mouse_key_t button, action_t action, modifier_key_t mods,
+			void *param);
+void	app_on_scroll(double xdelta, double ydelta, void *param);
+/* Headless mode: render the frame and save it to `path` (0 on success). */
+int		app_render_to_file(t_app *app, const char *path);
 
 #endif
\ No newline at end of file
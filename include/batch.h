@@ -0,0 +1,118 @@
+/*
+* One ray against many primitives, the dual of packet.h (many rays, one
+* primitive). Spheres, triangles and cylinders are also laid out as
+* structures of arrays, one float array per coordinate, so a single ray is tested against
+* BATCH_W consecutive entries in one pass of vector instructions. This
+* serves the incoherent rays (shadows, reflections) at mesh BVH leaves and
+* in small scenes scanned without a tree.
+* The kernels are built twice, for the baseline target and for AVX2, and
+* batch_ops() picks the one the running CPU supports.
+*/
+#ifndef BATCH_H
+# define BATCH_H
+
+# include "packet.h"
+
+# define BATCH_W 8
+# if defined(__x86_64__) || defined(__i386__)
+#  define BATCH_X86
+# endif
+
+/* Arrays are padded by BATCH_W entries so a batch may run off the end. */
+typedef struct s_sphere_soa
+{
+	float	*cx;
+	float	*cy;
+	float	*cz;
+	float	*r2;
+	int		count;
+}	t_sphere_soa;
+
+typedef struct s_tri_soa
+{
+	float	*ax;
+	float	*ay;
+	float	*az;
+	float	*e1x;
+	float	*e1y;
+	float	*e1z;
+	float	*e2x;
+	float	*e2y;
+	float	*e2z;
+	int		count;
+}	t_tri_soa;
+
+/* The fields hit_cylinder reads: centre, unit axis, cap centres, sizes. */
+typedef struct s_cyl_soa
+{
+	float	*cx;
+	float	*cy;
+	float	*cz;
+	float	*ax;
+	float	*ay;
+	float	*az;
+	float	*tx;
+	float	*ty;
+	float	*tz;
+	float	*bx;
+	float	*by;
+	float	*bz;
+	float	*r2;
+	float	*half_he;
+	int		count;
+}	t_cyl_soa;
+
+struct	s_cyl;
+
+/*
+* Distances from `r` to entries first .. first + BATCH_W - 1 into t[]
+* (<= 0 on miss), bit for bit those of the scalar packed tests.
+*/
+typedef void	(*t_batch_sphere)(const t_sphere_soa *s, int first, t_ray r,
+					float *t);
+typedef void	(*t_batch_tri)(const t_tri_soa *s, int first, t_ray r,
+					float *t);
+typedef void	(*t_batch_cyl)(const t_cyl_soa *s, int first, t_ray r,
+					float *t);
+
+typedef struct s_batch_ops
+{
+	const char		*isa;
+	t_batch_sphere	spheres;
+	t_batch_tri		tris;
+	t_batch_cyl		cylinders;
+}	t_batch_ops;
+
+/* Kernels for this CPU; cheap enough to call once per structure built. */
+const t_batch_ops	*batch_ops(void);
+
+/* Buffers (batch.c); init returns 0 on success, -1 on ENOMEM */
+int					sphere_soa_init(t_sphere_soa *s, int count);
+void				sphere_soa_set(t_sphere_soa *s, int i,
+						const t_sphere_hot *sp);
+void				sphere_soa_free(t_sphere_soa *s);
+int					tri_soa_init(t_tri_soa *s, int count);
+void				tri_soa_set(t_tri_soa *s, int i, const t_tri_hot *tr);
+t_tri_hot			tri_soa_get(const t_tri_soa *s, int i);
+void				tri_soa_free(t_tri_soa *s);
+int					cyl_soa_init(t_cyl_soa *s, int count);
+void				cyl_soa_set(t_cyl_soa *s, int i, const struct s_cyl *cy);
+void				cyl_soa_free(t_cyl_soa *s);
+
+/* Kernel variants (batch_kernels.c), selected by batch_ops() */
+void				batch_spheres_base(const t_sphere_soa *s, int first,
+						t_ray r, float *t);
+void				batch_tris_base(const t_tri_soa *s, int first, t_ray r,
+						float *t);
+void				batch_cylinders_base(const t_cyl_soa *s, int first,
+						t_ray r, float *t);
+# ifdef BATCH_X86
+void				batch_spheres_avx2(const t_sphere_soa *s, int first,
+						t_ray r, float *t);
+void				batch_tris_avx2(const t_tri_soa *s, int first, t_ray r,
+						float *t);
+void				batch_cylinders_avx2(const t_cyl_soa *s, int first,
+						t_ray r, float *t);
+# endif
+
+#endif
@@ -9,12 +9,22 @@ typedef struct s_bumpmap
     int     w;
     int     h;
     float   *hmap; // grayscale heights in [0,1], row-major size w*h
+    char    *path; // cache key (NULL for maps loaded outside the cache)
+    int     refs; // objects sharing this map
+    struct s_bumpmap *next; // next entry of the scene's bump cache
 }   t_bumpmap;
 
 // Load a PNG bump map (grayscale derived from RGBA) into a float height map
 t_bumpmap   *bump_load_png(const char *path);
 void        bump_free(t_bumpmap *bm);
 
+// Scene bump cache: each PNG path is decoded once and shared by refcount.
+// acquire returns the cached map (loading it on first use) or NULL on error;
+// release drops one reference and frees the map with the last one.
+t_bumpmap   *bump_acquire(t_bumpmap **cache, const char *path);
+void        bump_release(t_bumpmap **cache, t_bumpmap *bm);
+void        bump_cache_clear(t_bumpmap **cache);
+
 // Sample height with wrap repeat at normalized UV
 float       bump_sample(const t_bumpmap *bm, float u, float v);
 
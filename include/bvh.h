@@ -0,0 +1,171 @@
+/*
+* Bounding volume hierarchy over an arbitrary set of axis-aligned boxes.
+* The tree is stored as a flat node array (children of an inner node are
+* always adjacent) plus a permutation of primitive ids in leaf order, so it
+* holds no pointers and knows nothing about what the primitives are: callers
+* provide a leaf callback that intersects primitive `id`.
+* Being pointer-free, a built tree can also be cached on disk (bvh_cache.c,
+* when MINIRT_BVH_CACHE names a directory) and mapped back in by the next
+* run over the same boxes.
+* Single rays walk a collapsed copy of the tree (t_bvh_wide) that tests all
+* the children of a node with one vector slab test.
+*/
+#ifndef BVH_H
+# define BVH_H
+
+# include <stdbool.h>
+# include <stddef.h>
+# include "vec3.h"
+# include "ray.h"
+
+# define BVH_LEAF_MAX 4
+# define BVH_STACK 128
+/* Children per node of the collapsed tree: one AVX (else SSE) register. */
+# ifdef __AVX__
+#  define BVH_WIDE 8
+# else
+#  define BVH_WIDE 4
+# endif
+/*
+* A wide walk pushes at most BVH_WIDE - 1 extra entries per level, and a
+* tree deeper than BVH_STACK already overflows the binary walks.
+*/
+# define BVH_WIDE_STACK 896
+/* SAH cost of visiting an inner node / testing one primitive. */
+# define BVH_SAH_TRAVERSE 1.0f
+# define BVH_SAH_INTERSECT 1.0f
+/* Fewer primitives build faster than a cache file can be looked up. */
+# define BVH_CACHE_MIN 4096
+/* Bump whenever bvh_build starts producing a different tree. */
+# define BVH_CACHE_VERSION 2
+
+typedef struct s_aabb
+{
+	t_vec3	min;
+	t_vec3	max;
+}	t_aabb;
+
+/*
+* Node of the flat tree.
+* Leaf (count > 0): primitives bvh->index[first .. first + count).
+* Inner (count == 0): children are nodes[first] and nodes[first + 1].
+*/
+typedef struct s_bvh_node
+{
+	t_aabb	box;
+	int		first;
+	int		count;
+}	t_bvh_node;
+
+/*
+* Node of the collapsed tree: up to BVH_WIDE binary nodes of one subtree,
+* stored as slots with their boxes in SoA form (box[0..2] = min x, y, z,
+* box[3..5] = max x, y, z) so a single slab test covers every slot.
+* Slot i < used: count[i] > 0 is a leaf over index[first[i] .. + count[i]);
+* count[i] == 0 an inner node whose slots are wide[first[i]].
+*/
+typedef struct s_bvh_wide
+{
+	float	box[6][BVH_WIDE];
+	int		first[BVH_WIDE];
+	int		count[BVH_WIDE];
+	int		used;
+}	t_bvh_wide;
+
+/*
+* parent: parent of each node (-1 for the root).
+* leaf_of: leaf node holding each primitive id; with `parent` this gives
+* the path bvh_refit walks when one primitive moves.
+* map: when non-NULL, nodes and index live in this private mapping of a
+* cache file (map_size bytes) instead of their own allocations.
+* wide: the collapsed tree (root at 0); wide_slot: where each binary node's
+* box sits in it (node * BVH_WIDE + slot), -1 for nodes collapsed away.
+*/
+typedef struct s_bvh
+{
+	t_bvh_node	*nodes;
+	int			node_count;
+	int			*index;
+	int			count;
+	int			*parent;
+	int			*leaf_of;
+	void		*map;
+	size_t		map_size;
+	t_bvh_wide	*wide;
+	int			wide_count;
+	int			*wide_slot;
+}	t_bvh;
+
+/*
+* Shape of a built tree, as reported by bvh_stats.
+* depth: levels below the root of the deepest leaf.
+* sah_cost: expected cost of a ray that enters the root box, in the units
+* of BVH_SAH_TRAVERSE and BVH_SAH_INTERSECT.
+*/
+typedef struct s_bvh_stats
+{
+	int		nodes;
+	int		leaves;
+	int		depth;
+	float	sah_cost;
+}	t_bvh_stats;
+
+/*
+* Per-ray traversal state shared with the leaf callback.
+* tmax: current search bound; shrinks as closer hits are accepted.
+* best: id of the accepted primitive (-1 while nothing was hit).
+* any: stop the traversal at the first accepted hit (occlusion queries).
+*/
+typedef struct s_bvh_ray
+{
+	t_ray	r;
+	t_vec3	inv_dir;
+	float	tmax;
+	int		best;
+	int		any;
+	int		found;
+}	t_bvh_ray;
+
+/* Intersect primitive `id`; return 1 when the hit was accepted. */
+typedef int	(*t_bvh_leaf)(int id, t_bvh_ray *q, void *ctx);
+/* Intersect leaf positions first .. first + count; return 1 on an accept. */
+typedef int	(*t_bvh_span)(int first, int count, t_bvh_ray *q, void *ctx);
+
+/* AABB helpers (aabb.c) */
+t_aabb	aabb_empty(void);
+void	aabb_grow(t_aabb *box, t_vec3 p);
+void	aabb_merge(t_aabb *box, const t_aabb *other);
+void	aabb_pad(t_aabb *box);
+float	aabb_area(const t_aabb *box);
+float	v3_axis(t_vec3 v, int axis);
+bool	aabb_hit(const t_aabb *box, const t_bvh_ray *q, float *tnear);
+
+/*
+* Build / release (bvh_build.c); build returns 0 on success, -1 on ENOMEM.
+* Binned SAH splits; subtrees are built in parallel on the worker threads.
+*/
+int		bvh_build(t_bvh *bvh, const t_aabb *boxes, int count);
+void	bvh_free(t_bvh *bvh);
+/*
+* bvh_build through the on-disk cache (bvh_cache.c): same tree, mapped from
+* the cache when these exact boxes were built before.
+*/
+int		bvh_build_cached(t_bvh *bvh, const t_aabb *boxes, int count);
+/* Whole-tree passes (bvh_tree.c): derive parent/leaf_of; measure. */
+int		bvh_link(t_bvh *bvh);
+void	bvh_stats(const t_bvh *bvh, t_bvh_stats *st);
+/* Collapse into bvh->wide (bvh_wide.c); 0, or -1 on ENOMEM. */
+int		bvh_widen(t_bvh *bvh);
+void	bvh_wide_refit(t_bvh *bvh, int node);
+/* Grow/shrink the boxes above primitive `prim` to boxes[] (bvh_refit.c). */
+void	bvh_refit(t_bvh *bvh, const t_aabb *boxes, int prim);
+
+/* Queries (bvh_traverse.c) */
+void	bvh_ray_init(t_bvh_ray *q, t_ray r, float tmax, int any);
+bool	bvh_ray_accept(t_bvh_ray *q, float t, int id);
+void	bvh_traverse(const t_bvh *bvh, t_bvh_ray *q, t_bvh_leaf leaf,
+			void *ctx);
+void	bvh_traverse_spans(const t_bvh *bvh, t_bvh_ray *q, t_bvh_span span,
+			void *ctx);
+
+#endif
@@ -0,0 +1,80 @@
+/*
+* State shared by the pieces of the BVH builder (bvh_build.c, bvh_sah.c).
+*/
+#ifndef BVH_INTERNAL_H
+# define BVH_INTERNAL_H
+
+# include <stdatomic.h>
+# include "bvh.h"
+
+/* Centroid bins in the SAH split search. */
+# define BVH_BINS 16
+/*
+* Nodes this deep are split at the median instead of by the SAH, which
+* bounds the depth of any tree well inside BVH_STACK.
+*/
+# define BVH_SAH_DEPTH 48
+/* Subtrees of at most this many primitives are built as one pool task. */
+# define BVH_TASK_SIZE 16384
+
+/* Primitives prims[first, first + count), `depth` levels below the root. */
+typedef struct s_bvh_range
+{
+	int	first;
+	int	count;
+	int	depth;
+}	t_bvh_range;
+
+/* Growing node array a (sub)tree is built into; count = nodes used. */
+typedef struct s_bvh_out
+{
+	t_bvh_node	*nodes;
+	int			count;
+}	t_bvh_out;
+
+/*
+* A subtree left to the task pool. Its root is the node `slot` of the final
+* array; the task builds the whole subtree into `out` (root at 0) and the
+* nodes are appended to the final array afterwards, in task order.
+*/
+typedef struct s_bvh_task
+{
+	int			slot;
+	t_bvh_range	range;
+	t_bvh_out	out;
+}	t_bvh_task;
+
+/* A primitive as the builder sorts it: its box, centroid and id. */
+typedef struct s_bvh_prim
+{
+	t_aabb	box;
+	t_vec3	centroid;
+	int		id;
+}	t_bvh_prim;
+
+/*
+* prims: every primitive, reordered in place into leaf order (their ids
+* become bvh->index); tasks own disjoint ranges of it.
+* tasks: subtrees set aside by the serial top pass (when `pool` is set).
+* next: first task not yet claimed by a worker.
+*/
+typedef struct s_bvh_builder
+{
+	t_bvh_prim		*prims;
+	int				pool;
+	t_bvh_task		*tasks;
+	int				task_count;
+	int				task_cap;
+	int				failed;
+	atomic_int		next;
+}	t_bvh_builder;
+
+/*
+* Choose how to split the node over `r`, whose centroids span `cbox`, and
+* reorder prims[] to match (bvh_sah.c).
+* Returns: The first position of the right child, or -1 when the node
+* stays a leaf.
+*/
+int		bvh_split(const t_bvh_builder *b, t_bvh_range r, const t_aabb *cbox);
+
+#endif
@@ -21,5 +21,7 @@ typedef struct s_cam_frame
 
 void	camera_build_frame(const t_camera *cam, int width, int height,
 			t_cam_frame *out);
+/* Primary ray through (u, v) in [0,1]^2, v = 0 at the bottom of the view. */
+t_ray	camera_ray(const t_cam_frame *fr, float u, float v);
 
 #endif
@@ -0,0 +1,27 @@
+#ifndef CLI_H
+# define CLI_H
+
+/* Largest accepted --size dimension (keeps w * h * 4 well inside size_t). */
+# define CLI_MAX_DIM 16384
+
+/*
+* Command line options.
+* scene_path: .rt file to load.
+* output: image path for headless mode (.ppm or .png), NULL for a window.
+* width/height: frame size; WIN_W x WIN_H unless --size WxH is given.
+*/
+typedef struct s_cli
+{
+	const char	*scene_path;
+	const char	*output;
+	int			width;
+	int			height;
+}	t_cli;
+
+/* Fill `cli` from argv; returns 0 on success, -1 on bad usage. */
+int		cli_parse(int ac, char **av, t_cli *cli);
+void	cli_usage(const char *prog);
+/* Parse "WxH" (each side in [1, CLI_MAX_DIM]); 0 on success, -1 if bad. */
+int		cli_parse_size(const char *s, int *width, int *height);
+
+#endif
@@ -0,0 +1,51 @@
+/*
+* Interactive scene editing from the window: what the movement keys and the
+* mouse act on (camera, light or a picked object) and the per-type object
+* edits behind them. Every edit is followed by accel_update for the object
+* and a coarse progressive re-render (render_moved).
+*/
+#ifndef CONTROLS_H
+# define CONTROLS_H
+
+# include <stdbool.h>
+# include "vec3.h"
+# ifndef SCENE_HEADER
+#  define SCENE_HEADER "scene.h"
+# endif
+# include SCENE_HEADER
+
+// Translation step as a fraction of the scene's bounding box diagonal
+# define MOVE_FRACTION 0.02f
+// Rotation per arrow key press (degrees) and resize factor per wheel notch
+# define TURN_DEG 5.0f
+# define SCALE_STEP 1.1f
+
+typedef enum e_target
+{
+	TARGET_CAMERA,
+	TARGET_LIGHT,
+	TARGET_OBJECT
+}	t_target;
+
+/*
+* target: what the controls move.
+* id, obj: picked object (its accel id and list node) for TARGET_OBJECT;
+* id alone is the index of the light for TARGET_LIGHT.
+*/
+typedef struct s_selection
+{
+	t_target	target;
+	int			id;
+	t_object	*obj;
+}	t_selection;
+
+/*
+* In-place object edits (object_edit.c / object_edit_bonus.c).
+* Return false when the edit means nothing for that type (rotating a
+* sphere, resizing an infinite plane), so no re-render is needed.
+*/
+bool	object_translate(t_object *obj, t_vec3 d);
+bool	object_rotate(t_object *obj, t_vec3 axis, float angle);
+bool	object_scale(t_object *obj, float factor);
+
+#endif
@@ -0,0 +1,42 @@
+/*
+* Per-pixel G-buffer of the interactive renderer.
+* Tracing a pixel stores everything its shading depends on except the
+* light colour/brightness and the ambient term, which are applied when the
+* pixel is shaded: the surface, and which lights its shadow rays reached.
+* Switching the display mode or tweaking those values then re-shades the
+* stored texels without tracing a single ray (except for the brightness in
+* scenes with more lights than SHADOW_BUDGET, whose light sampling depends
+* on it).
+*/
+#ifndef GBUFFER_H
+# define GBUFFER_H
+
+# include <stdint.h>
+# include "vec3.h"
+
+/* Most shadow rays traced for one pixel, whatever the number of lights. */
+# define SHADOW_BUDGET 4
+
+/*
+* p, n, albedo: hit point, final shading normal and surface colour.
+* ks, shininess: the material's Blinn-Phong terms (ks 0 for objects without
+* a specular material); the highlight itself depends on each light's
+* position and is evaluated when shading.
+* hit: the primary ray hit something.
+* lit: number of lights that reach p, listed in light[] with the weight
+* their contribution gets (1, or 1/p for a randomly sampled weak light).
+*/
+typedef struct s_gbuf_px
+{
+	t_vec3		p;
+	t_vec3		n;
+	t_vec3		albedo;
+	float		ks;
+	float		shininess;
+	float		weight[SHADOW_BUDGET];
+	uint16_t	light[SHADOW_BUDGET];
+	uint8_t		hit;
+	uint8_t		lit;
+}	t_gbuf_px;
+
+#endif
@@ -0,0 +1,16 @@
+/*
+* Fast 64-bit content hash (FNV-1a fed a word at a time), used to key the
+* on-disk caches by the data they were built from.
+*/
+#ifndef HASH_H
+# define HASH_H
+
+# include <stddef.h>
+# include <stdint.h>
+
+# define HASH_SEED 14695981039346656037ull
+
+/* Continue hash `h` over the `n` bytes at `p`. */
+uint64_t	hash_words(uint64_t h, const void *p, size_t n);
+
+#endif
@@ -29,11 +29,30 @@ typedef struct s_sp_aux
 	float	disc;
 }   t_sp_aux;
 
+/* Part of a cylinder reported by hit_cylinder. */
+typedef enum e_cyl_part
+{
+	CYL_SIDE,
+	CYL_TOP,
+	CYL_BOTTOM
+}	t_cyl_part;
+
 int		scene_hit(const t_scene *scene, t_ray r, float max_dist, t_hit *out);
+/* Any-hit test for shadow rays: 1 if something lies in (EPSILON, max_dist). */
+int		scene_occluded(const t_scene *scene, t_ray r, float max_dist);
+/* Id (position in scene->objects) of the closest object along r, or -1. */
+int		scene_pick(const t_scene *scene, t_ray r);
+/*
+* scene_hit(..., FLT_MAX, ...) for up to PACKET_W coherent rays, traced
+* together as one packet; gives the same hits as separate calls.
+*/
+void	scene_hit_packet(const t_scene *scene, const t_ray *rays, int count,
+			t_hit *out);
 
 /* HIT OBJECTS */
 float	hit_sphere(const t_sphere *sp, t_ray r);
 float	hit_plane(const t_plane *pl, t_ray r);
+void	cylinder_prepare(t_cyl *cy);
 float	hit_cylinder(const t_cyl *cy, t_ray r, int *hit_part);
 
 #endif
@@ -15,7 +15,6 @@ typedef struct s_hit
 	t_vec3	albedo; // Color del objeto intersectado
 	float	ks;
 	float	shininess;
-	t_vec3	specular;
 }	t_hit;
 
 typedef struct s_sp_aux
@@ -57,13 +56,51 @@ typedef struct s_hp_aux
 	float		cands[2];
 }	t_hp_aux;
 
+/*
+* Surface frame of a cylinder hit (side or cap), for its hit record.
+* n, tan, bit: outward normal and the tangent basis bump maps perturb it in.
+* u, v: position on the surface in world units (checker tiles).
+* tu, tv: the same position in [0,1] texture space (bump map).
+*/
+typedef struct s_cy_aux
+{
+	t_vec3	n;
+	t_vec3	tan;
+	t_vec3	bit;
+	float	u;
+	float	v;
+	float	tu;
+	float	tv;
+}	t_cy_aux;
+
+/* Part of a cylinder reported by hit_cylinder. */
+typedef enum e_cyl_part
+{
+	CYL_SIDE,
+	CYL_TOP,
+	CYL_BOTTOM
+}	t_cyl_part;
+
 int		scene_hit(const t_scene *scene, t_ray r, float max_dist, t_hit *out);
+/* Any-hit test for shadow rays: 1 if something lies in (EPSILON, max_dist). */
+int		scene_occluded(const t_scene *scene, t_ray r, float max_dist);
+/* Id (position in scene->objects) of the closest object along r, or -1. */
+int		scene_pick(const t_scene *scene, t_ray r);
+/*
+* scene_hit(..., FLT_MAX, ...) for up to PACKET_W coherent rays, traced
+* together as one packet; gives the same hits as separate calls.
+*/
+void	scene_hit_packet(const t_scene *scene, const t_ray *rays, int count,
+			t_hit *out);
 
 /* HIT OBJECTS */
 float	hit_sphere(const t_sphere *sp, t_ray r);
 float	hit_plane(const t_plane *pl, t_ray r);
+void	triangle_prepare(t_triangle *tr);
 float	hit_triangle(const t_triangle *tr, t_ray r);
-float	hit_cylinder(const t_cyl *cy, t_ray r);
+void	cylinder_prepare(t_cyl *cy);
+float	hit_cylinder(const t_cyl *cy, t_ray r, int *hit_part);
+void	hparab_prepare(t_hparab *hp);
 float	hit_hparaboloid(const t_hparab *hp, t_ray r);
 
 #endif
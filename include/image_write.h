@@ -0,0 +1,43 @@
+/*
+* Writing the framebuffer (0xRRGGBBAA pixels) to image files, used by the
+* headless --output mode. Only binary PPM and PNG are supported; the PNG
+* encoder stores the pixels uncompressed so it needs no zlib.
+*/
+#ifndef IMAGE_WRITE_H
+# define IMAGE_WRITE_H
+
+# include <stddef.h>
+# include <stdint.h>
+
+# define OUTBUF_SIZE 65536
+
+typedef enum e_img_format
+{
+	IMG_UNKNOWN = -1,
+	IMG_PPM,
+	IMG_PNG
+}	t_img_format;
+
+/* Buffered file writer; err is set once any write fails. */
+typedef struct s_outbuf
+{
+	int		fd;
+	int		err;
+	size_t	len;
+	uint8_t	data[OUTBUF_SIZE];
+}	t_outbuf;
+
+void			outbuf_put(t_outbuf *o, const void *src, size_t n);
+void			outbuf_flush(t_outbuf *o);
+
+/* Pick the format from the file extension (.ppm / .png). */
+t_img_format	image_format(const char *path);
+/* Write a w x h framebuffer to `path`; 0 on success, -1 on I/O error. */
+int				image_write(const char *path, const uint32_t *fb,
+					int w, int h);
+void			image_write_ppm(t_outbuf *o, const uint32_t *fb,
+					int w, int h);
+int				image_write_png(t_outbuf *o, const uint32_t *fb,
+					int w, int h);
+
+#endif
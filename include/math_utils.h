@@ -1,11 +1,14 @@
 #ifndef MATH_UTILS_H
 # define MATH_UTILS_H
 
+# include "vec3.h"
+
 #ifndef M_PI
 # define M_PI 3.1415926535897932385
 #endif
 
 float	deg2rad(float d);
 float	clampf(float value, float min, float max);
+t_vec3	v3_rotate(t_vec3 v, t_vec3 axis, float angle);
 
 #endif
@@ -0,0 +1,81 @@
+/*
+* Packed, per-type copies of the intersection data of the scene objects.
+* The t_object list stays the owner of everything the parser produced, but
+* each t_object is a union sized by its largest member and reached through a
+* pointer, so an intersection test used to pull a cache line full of colour,
+* checker, bump and material fields it never reads. After parsing, the
+* common primitives are compiled into tight arrays holding only what their
+* distance test needs (hot data). The t_object is only touched again for
+* the winning hit, to shade it (cold data).
+*/
+#ifndef PACKED_H
+# define PACKED_H
+
+# include <stdbool.h>
+# include "vec3.h"
+# include "ray.h"
+
+/* PK_OTHER: no packed form, intersect through the t_object itself. */
+typedef enum e_pack_kind
+{
+	PK_OTHER,
+	PK_SPHERE,
+	PK_PLANE,
+	PK_TRIANGLE,
+	PK_KINDS
+}	t_pack_kind;
+
+/* r2: squared radius, the only size hit_sphere actually uses. */
+typedef struct s_sphere_hot
+{
+	t_vec3	center;
+	float	r2;
+}	t_sphere_hot;
+
+typedef struct s_plane_hot
+{
+	t_vec3	point;
+	t_vec3	normal;
+}	t_plane_hot;
+
+/* e1 = b - a, e2 = c - a, as computed by hit_triangle. */
+typedef struct s_tri_hot
+{
+	t_vec3	a;
+	t_vec3	e1;
+	t_vec3	e2;
+}	t_tri_hot;
+
+/* Where object id's hot data lives: kind and index in that kind's array. */
+typedef struct s_prim_ref
+{
+	int	kind;
+	int	slot;
+}	t_prim_ref;
+
+typedef struct s_packed
+{
+	t_prim_ref		*refs;
+	t_sphere_hot	*spheres;
+	t_plane_hot		*planes;
+	t_tri_hot		*tris;
+	int				count[PK_KINDS];
+}	t_packed;
+
+/* Per-build object description (pack.c / pack_bonus.c) */
+struct	s_object;
+int		object_pack_kind(const struct s_object *obj);
+void	object_pack(t_packed *p, const struct s_object *obj, int slot);
+
+/* Build / release (packed.c); build returns 0 on success, -1 on ENOMEM */
+int		packed_build(t_packed *p, const struct s_object **objects, int count);
+void	packed_free(t_packed *p);
+/*
+* Distance to object `id` from its packed data (<= 0 on miss).
+* Returns false when the object has no packed form (PK_OTHER).
+*/
+bool	packed_t(const t_packed *p, int id, t_ray r, float *t);
+/* Ray/triangle distance from the packed layout (<= 0 on miss). */
+float	tri_hot_t(const t_tri_hot *tr, t_ray r);
+
+#endif
@@ -0,0 +1,102 @@
+/*
+* 8-wide ray packets for coherent rays (neighbouring primary rays).
+* A packet walks the BVH once for all its rays: every node box and every
+* packed sphere/plane/triangle is tested against the 8 rays at once with
+* GCC/Clang vector extensions, which -march=native maps to one AVX2
+* register (two SSE registers elsewhere). Each lane keeps its own scalar
+* t_bvh_ray, so acceptance and tie-breaking are exactly those of a single
+* ray and a packet returns the same hits as PACKET_W separate traversals.
+*/
+#ifndef PACKET_H
+# define PACKET_H
+
+# include "bvh.h"
+# include "packed.h"
+
+# define PACKET_W 8
+# define PACKET_ALL 0xFF
+
+typedef float	t_f8 __attribute__((vector_size(32)));
+typedef int		t_i8 __attribute__((vector_size(32)));
+
+/*
+* q: per-lane ray state, the reference for tmax/best/found.
+* o*, d*, i*: the same origins, directions and inverse directions as SoA.
+* tmax: copy of q[i].tmax for the vector box test (see packet_accept).
+* live: lanes holding a ray (bit i = lane i); a run may be shorter than 8.
+* ctx: per-lane context handed to the caller's leaf callbacks.
+*/
+typedef struct s_packet
+{
+	t_bvh_ray	q[PACKET_W];
+	t_f8		ox;
+	t_f8		oy;
+	t_f8		oz;
+	t_f8		dx;
+	t_f8		dy;
+	t_f8		dz;
+	t_f8		ix;
+	t_f8		iy;
+	t_f8		iz;
+	t_f8		tmax;
+	int			live;
+	void		*ctx[PACKET_W];
+}	t_packet;
+
+/* Lane-wise `m ? a : b` (m lanes are all ones or all zeros). */
+static inline t_f8	f8_select(t_i8 m, t_f8 a, t_f8 b)
+{
+	return ((t_f8)(((t_i8)a & m) | ((t_i8)b & ~m)));
+}
+
+/* Lane-wise fminf / fmaxf, including their "ignore a NaN operand" rule. */
+static inline t_f8	f8_min(t_f8 a, t_f8 b)
+{
+	return (f8_select((a < b) | (b != b), a, b));
+}
+
+static inline t_f8	f8_max(t_f8 a, t_f8 b)
+{
+	return (f8_select((a > b) | (b != b), a, b));
+}
+
+/* Bit i set when lane i of the comparison result is true. */
+static inline int	i8_bits(t_i8 m)
+{
+	int	bits;
+	int	i;
+
+	bits = 0;
+	i = -1;
+	while (++i < PACKET_W)
+		if (m[i])
+			bits |= 1 << i;
+	return (bits);
+}
+
+/* Intersect primitive `id` for the lanes set in `mask`. */
+typedef void	(*t_packet_leaf)(int id, t_packet *pk, int mask, void *ctx);
+
+/* Setup and per-lane bookkeeping (packet.c) */
+void	packet_init(t_packet *pk, const t_ray *rays, int count, float tmax);
+bool	packet_accept(t_packet *pk, int lane, float t, int id);
+int		packet_lane_count(int mask);
+/* Run a scalar leaf for each lane in `mask` (objects with no packet test) */
+void	packet_scalar(t_packet *pk, int mask, t_bvh_leaf leaf, int id);
+/* Walk `bvh` for the lanes in `mask`; lone lanes fall back to scalar boxes */
+void	packet_traverse(const t_bvh *bvh, t_packet *pk, int mask,
+			t_packet_leaf leaf, void *ctx);
+
+/*
+* Packed-primitive kernels (packet_hit.c): distance per lane into t[]
+* (<= 0 on miss), with the float operations of the scalar packed tests.
+*/
+void	packet_sphere(const t_sphere_hot *sp, const t_packet *pk, float *t);
+void	packet_plane(const t_plane_hot *pl, const t_packet *pk, float *t);
+void	packet_tri(const t_tri_hot *tr, const t_packet *pk, float *t);
+/* Let each lane in `mask` accept t[lane] > EPSILON as a hit on `id`. */
+void	packet_offer(t_packet *pk, int mask, const float *t, int id);
+/* Test packed object `id` for `mask`; false when it has no packed form. */
+bool	packet_packed(const t_packed *p, int id, t_packet *pk, int mask);
+
+#endif
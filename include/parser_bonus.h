@@ -28,6 +28,12 @@ typedef struct s_parse_result
 * Returns a parse result (ok or error).
 */
 t_parse_result	parse_scene(const char *path, t_scene *out);
+/*
+* Same, going through the .rtb cache next to the file (rtb_bonus.h): a
+* cache matching the .rt is loaded instead of parsing, and a fresh parse
+* rewrites it.
+*/
+t_parse_result	scene_load(const char *path, t_scene *out);
 /* Free resources in a parse result (message). */
 void			parse_result_free(t_parse_result *r);
 
@@ -5,10 +5,39 @@
 # include <stdbool.h>
 # include "parser_bonus.h"
 
-char			**read_file_lines(const char *path, size_t *out_count);
-void			free_lines(char **lines, size_t count);
-char			**split_ws(const char *s);
-void			free_tokens(char **toks);
+/* Most whitespace-separated fields on one scene line. */
+# define PARSE_MAX_TOKENS 32
+/* Longest scene line accepted, terminator included. */
+# define PARSE_LINE_MAX 4096
+/* Mapped files from this size on are parsed on several threads. */
+# define PARSE_PAR_MIN 1048576
+
+/*
+* Scene source read line by line.
+* map, size: the whole file mapped read-only, when it is a regular file;
+* otherwise buf holds the unread part of a pipe or stdin (size bytes).
+* pos: offset of the next line; err: message of the failure, if any.
+*/
+typedef struct s_line_reader
+{
+	int			fd;
+	const char	*map;
+	size_t		size;
+	size_t		pos;
+	const char	*err;
+	char		buf[65536];
+}	t_line_reader;
+
+int				reader_open(t_line_reader *rd, const char *path);
+void			reader_view(t_line_reader *rd, const char *data, size_t size);
+int				reader_next(t_line_reader *rd, char *line);
+void			reader_close(t_line_reader *rd);
+t_parse_result	parse_line(char *line, int line_no, t_scene *scene);
+t_parse_result	parse_parallel(const t_line_reader *rd, t_scene *scene,
+					int threads);
+int				split_ws(char *line, char **tokens, int max);
+bool			scan_float(const char **s, float *out);
+bool			scan_int_in_range(const char **s, int minv, int maxv, int *out);
 bool			parse_float(const char *s, float *out);
 bool			parse_int_in_range(const char *s, int minv, int maxv, int *out);
 bool			parse_vec3(const char *s, t_vec3 *out);
@@ -27,5 +56,6 @@ t_parse_result	parse_pl_bo(char **tokens, int line, t_scene *scene);
 t_parse_result	parse_cy_bo(char **tokens, int line, t_scene *scene);
 t_parse_result	parse_tr(char **tokens, int line, t_scene *scene);
 t_parse_result	parse_hp(char **tokens, int line, t_scene *scene);
+t_parse_result	parse_mesh(char **tokens, int line, t_scene *scene);
 
 #endif
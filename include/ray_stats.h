@@ -0,0 +1,28 @@
+/*
+* Ray counters for the benchmark binary (built with -DMINIRT_STATS).
+* Each render thread counts into its own thread-local variable and folds
+* it into a shared atomic once its tiles are done, so counting adds no
+* contention. In the regular builds every hook compiles to nothing.
+*/
+#ifndef RAY_STATS_H
+# define RAY_STATS_H
+
+# include <stdint.h>
+
+# ifdef MINIRT_STATS
+
+extern _Thread_local uint64_t	g_stat_shadow_rays;
+
+#  define STAT_SHADOW_RAY() (g_stat_shadow_rays++)
+
+/* Add the calling thread's counts to the totals and reset them. */
+void		ray_stats_flush_thread(void);
+/* Return the shadow ray total since the last call and reset it. */
+uint64_t	ray_stats_take_shadow(void);
+
+# else
+#  define STAT_SHADOW_RAY() ((void)0)
+#  define ray_stats_flush_thread() ((void)0)
+# endif
+
+#endif
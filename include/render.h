@@ -2,6 +2,7 @@
 # define  RENDER_H
 
 # include <stdint.h>
+# include <stdatomic.h>
 # include "minirt.h"
 
 // Allow selecting the scene header used by camera.h from callers (bonus vs mandatory)
@@ -9,21 +10,78 @@
 # define SCENE_HEADER "scene.h"
 #endif
 #include "camera.h"
+# include "gbuffer.h"
+# include "packet.h"
+
+// Screen tiles handed out to render workers (pixels per side)
+# define TILE_SIZE 32
+// Progressive window rendering: coarsest sample spacing (a power of two
+// dividing TILE_SIZE) and the render time spent per displayed frame
+# define PROGRESS_START 4
+# define PROGRESS_BUDGET_MS 30
+// While edits keep coming (key repeat), stay at the coarse pass until
+// input has been quiet this long
+# define PROGRESS_SETTLE_MS 150
 
 // Forward declaration to avoid pulling app/scene into this public header
 struct s_app;
 typedef struct s_app t_app;
 
-typedef struct s_render_aux
+/*
+* Pixels of one row traced together as a ray packet: (x[i], y), i < count.
+* They need not be adjacent (progressive passes use every 2nd/4th pixel).
+*/
+typedef struct s_pixel_run
+{
+	int	x[PACKET_W];
+	int	y;
+	int	count;
+}	t_pixel_run;
+
+/*
+* Shared state of one multithreaded frame.
+* Workers claim tile indices from `next` until it runs past `tile_count`;
+* tiles never overlap so framebuffer writes need no locking.
+* reshade: shade the stored G-buffer instead of tracing rays.
+*/
+typedef struct s_tile_job
 {
+	t_app		*app;
 	t_cam_frame	frame;
-	float		u;
-	float		v;
-	t_vec3		sample;
-	t_vec3		dir;
-}	t_render_aux;
+	int			reshade;
+	int			width;
+	int			height;
+	int			tiles_x;
+	int			tile_count;
+	atomic_int	next;
+}	t_tile_job;
 
-void	render_scene(t_app *app);
-void	upload_framebuffer(mlx_image_t *image, const uint32_t *fb);
+/*
+* One progressive pass in flight: like t_tile_job, but only pixels on the
+* `step` grid are traced and workers stop claiming tiles after `deadline`
+* (CLOCK_MONOTONIC nanoseconds).
+*/
+typedef struct s_prog_job
+{
+	t_app		*app;
+	t_cam_frame	frame;
+	int			step;
+	int			tiles_x;
+	int			tile_count;
+	long long	deadline;
+	atomic_int	next;
+}	t_prog_job;
+
+void		render_scene(t_app *app);
+/* Progressive window rendering (progressive.c) */
+void		render_invalidate(t_app *app);
+void		render_moved(t_app *app);
+void		render_progress_frame(void *param);
+/* Re-shade app->gbuf into the framebuffer (no rays); needs app->gbuf. */
+void		render_reshade(t_app *app);
+void		render_run(const t_app *app, const t_cam_frame *frame,
+				const t_pixel_run *run);
+uint32_t	shade_pixel(const t_app *app, const t_gbuf_px *px);
+void		upload_framebuffer(mlx_image_t *image, const uint32_t *fb);
 
-#endif
\ No newline at end of file
+#endif
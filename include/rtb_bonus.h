@@ -0,0 +1,75 @@
+/*
+* .rtb: binary cache of a parsed bonus scene, kept next to its source
+* (scene.rt -> scene.rtb) and reused while the source is unchanged.
+*
+* Layout, all in host byte order:
+*   t_rtb_header
+*   t_light    [light_count]
+*   zero padding up to rtb_objects_offset(), a multiple of RTB_ALIGN
+*   t_object   [object_count]   records as in memory, with next = NULL,
+*                               material = 1-based index into materials,
+*                               bump = 1-based offset into strings
+*   t_material [material_count]
+*   char       [string_bytes]   bump map paths, each NUL-terminated
+*
+* Records are raw structs, so the header carries their sizes and a file
+* written by a build with another layout is ignored. Bump RTB_VERSION
+* whenever a scene struct changes without changing size.
+* Scenes holding OBJ meshes are not cached: their data lives in the .obj.
+* The loader maps the file privately and uses the objects, materials and
+* paths in place, which is why the object section is aligned.
+*/
+#ifndef RTB_BONUS_H
+# define RTB_BONUS_H
+
+# include <stdint.h>
+# include <stddef.h>
+# include "scene_bonus.h"
+
+/* "RTB1" read as a little-endian word. */
+# define RTB_MAGIC 0x31425452u
+# define RTB_VERSION 2
+/* Alignment of the object section in the file (see rtb_objects_offset). */
+# define RTB_ALIGN 64
+/* Read size used to hash the source; a multiple of the 8-byte hash word. */
+# define RTB_HASH_CHUNK 262144
+
+/* What the cache was built from: size, mtime and hash of the .rt text. */
+typedef struct s_rtb_key
+{
+	uint64_t	size;
+	int64_t		mtime;
+	uint64_t	hash;
+}	t_rtb_key;
+
+typedef struct s_rtb_header
+{
+	uint32_t	magic;
+	uint32_t	version;
+	uint32_t	object_size;
+	uint32_t	light_size;
+	uint32_t	material_size;
+	uint32_t	light_count;
+	uint32_t	object_count;
+	uint32_t	material_count;
+	uint64_t	string_bytes;
+	t_rtb_key	key;
+	t_ambient	ambient;
+	t_camera	camera;
+}	t_rtb_header;
+
+/* File offset of the object section of a cache with header `h`. */
+uint64_t			rtb_objects_offset(const t_rtb_header *h);
+/* Key of the scene source at `path`; -1 if it cannot be read. */
+int					rtb_source_key(const char *path, t_rtb_key *key);
+/* Fill `scene` from the cache at `rtb_path` if it matches `key`; 0 on hit. */
+int					rtb_load(const char *rtb_path, const t_rtb_key *key,
+						t_scene *scene);
+/* Write `scene` to `rtb_path` (through a temporary file); 0 on success. */
+int					rtb_save(const char *rtb_path, const t_rtb_key *key,
+						const t_scene *scene);
+/* Where object `o` keeps its material / bump map (NULL for meshes). */
+t_material			**rtb_material_slot(t_object *o);
+struct s_bumpmap	**rtb_bump_slot(t_object *o);
+
+#endif
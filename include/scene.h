@@ -45,14 +45,12 @@ typedef struct s_camera
 * bright: brightness/intensity in [0,1].
 * color: per-channel color in [0,1] (optional in subject,
 * stored for extensibility).
-* present: whether it was declared in the scene file.
 */
 typedef struct s_light
 {
 	t_vec3	pos;
 	float	bright; // [0,1]
 	t_vec3	color; // [0,1]
-	bool	present;
 }	t_light;
 
 /* Object kinds supported in the mandatory part. */
@@ -67,7 +65,9 @@ typedef enum e_objtype
 * Object payloads.
 * sphere: center, diameter (>0), and albedo color ([0,1] per channel).
 * plane: point, normalized normal, and albedo color.
-* cylinder: center, normalized axis, diameter (>0), height (>0), albedo color.
+* cylinder: center, normalized axis, diameter (>0), height (>0), albedo color;
+* top, bottom, r2, half_he (cap centres, squared radius, half height) are
+* derived by cylinder_prepare.
 */
 typedef struct s_sphere
 {
@@ -90,6 +90,10 @@ typedef struct s_cyl
 	float	di;
 	float	he;
 	t_vec3	color;
+	t_vec3	top;
+	t_vec3	bottom;
+	float	r2;
+	float	half_he;
 }	t_cyl;
 
 /*
@@ -110,15 +114,24 @@ typedef struct s_object
 	struct s_object	*next;
 }	t_object;
 
+/* Built by scene_build_accel (accel.h) once parsing is done. */
+struct	s_accel;
+
 /*
 * Scene root object holding global entities and the object list.
+* lights: the light_count point lights (exactly one once parsed, the
+* mandatory part allows a single L; light_cap slots allocated).
+* accel: BVH over the objects, NULL until scene_build_accel runs.
 */
 typedef struct s_scene
 {
-	t_ambient	ambient;
-	t_camera	camera;
-	t_light		light;
-	t_object	*objects;
+	t_ambient		ambient;
+	t_camera		camera;
+	t_light			*lights;
+	int				light_count;
+	int				light_cap;
+	t_object		*objects;
+	struct s_accel	*accel;
 }	t_scene;
 
 /* Initialize a scene with defaults and no objects. */
@@ -127,5 +140,9 @@ void	scene_init(t_scene *s);
 void	scene_free(t_scene *s);
 /* Push an object into the scene object list (O(1)). */
 void	scene_add_object(t_scene *s, t_object *obj);
+/* Record the scene's light; returns NULL or an error message. */
+const char	*scene_add_light(t_scene *s, const t_light *l);
+/* Move the objects of `from` in front of those of `s`, emptying `from`. */
+void	scene_adopt(t_scene *s, t_scene *from);
 
 #endif
@@ -7,6 +7,7 @@
 # define SCENE_BONUS_H
 
 # include <stdbool.h>
+# include <stddef.h>
 # include <stdint.h>
 # include "vec3.h"
 #include "material_bonus.h"
@@ -49,14 +50,12 @@ typedef struct s_camera
 * bright: brightness/intensity in [0,1].
 * color: per-channel color in [0,1] (optional in subject,
 * stored for extensibility).
-* present: whether it was declared in the scene file.
 */
 typedef struct s_light
 {
 	t_vec3	pos;
 	float	bright; // [0,1]
 	t_vec3	color; // [0,1]
-	bool	present;
 }	t_light;
 
 /* Object kinds supported in the mandatory part. */
@@ -66,14 +65,17 @@ typedef enum e_objtype
 	OBJ_PLANE,
 	OBJ_CYLINDER,
 	OBJ_TRIANGLE,
-	OBJ_HPARABOLOID
+	OBJ_HPARABOLOID,
+	OBJ_MESH
 }	t_objtype;
 
 /*
 * Object payloads.
 * sphere: center, diameter (>0), and albedo color ([0,1] per channel).
 * plane: point, normalized normal, and albedo color.
-* cylinder: center, normalized axis, diameter (>0), height (>0), albedo color.
+* cylinder: center, normalized axis, diameter (>0), height (>0), albedo color;
+* top, bottom, r2, half_he (cap centres, squared radius, half height) are
+* derived by cylinder_prepare.
 */
 typedef struct s_sphere
 {
@@ -110,6 +112,12 @@ typedef struct s_cyl
 	float	di;
 	float	he;
 	t_vec3	color;
+	t_vec3	top;
+	t_vec3	bottom;
+	float	r2;
+	float	half_he;
+	int		has_checker;
+	float	checker_scale;
 	int		has_bump;
 	float	bump_strength;
 	struct s_bumpmap	*bump;
@@ -119,6 +127,9 @@ typedef struct s_cyl
 /*
 * Triangle primitive (non-mandatory; used by OBJ->RT tool and tests).
 * a,b,c: triangle vertices in world space.
+* e1,e2,n: edges b - a, c - a and unit normal, filled by triangle_prepare.
+* d00,d01,d11,inv_denom: barycentric setup (edge dot products and the
+* inverse of d00 * d11 - d01^2; 0 for degenerate triangles).
 * color: albedo per channel in [0,1].
 */
 typedef struct s_triangle
@@ -126,6 +137,13 @@ typedef struct s_triangle
 	t_vec3	a;
 	t_vec3	b;
 	t_vec3	c;
+	t_vec3	e1;
+	t_vec3	e2;
+	t_vec3	n;
+	float	d00;
+	float	d01;
+	float	d11;
+	float	inv_denom;
 	t_vec3	color;
 	int		has_checker;
 	float	checker_scale;
@@ -159,6 +177,17 @@ typedef struct s_hparab
 	t_material 			*material;
 }	t_hparab;
 
+/*
+* Triangle mesh loaded from an OBJ file (see mesh_bonus.h).
+* data: shared vertex/index buffers and the per-mesh BVH.
+* color: albedo for every triangle of the mesh.
+*/
+typedef struct s_mesh
+{
+	struct s_mesh_data	*data;
+	t_vec3				color;
+}	t_mesh;
+
 /*
 * Scene object node (singly-linked list).
 * type: which shape the union holds.
@@ -175,19 +204,35 @@ typedef struct s_object
 		t_cyl		cy;
 		t_triangle	tr;
 		t_hparab	hp;
+		t_mesh		me;
 	} u_obj;
 	struct s_object	*next;
 }	t_object;
 
+/* Built by scene_build_accel (accel.h) once parsing is done. */
+struct	s_accel;
+
 /*
 * Scene root object holding global entities and the object list.
+* lights: the light_count point lights, in file order (light_cap slots
+* allocated).
+* accel: BVH over the objects, NULL until scene_build_accel runs.
+* block: set when the scene came from a .rtb cache (rtb_bonus.h): the
+* private mapping of that file (block_size bytes), in which its objects
+* and materials live.
 */
 typedef struct s_scene
 {
-	t_ambient	ambient;
-	t_camera	camera;
-	t_light		light;
-	t_object	*objects;
+	t_ambient			ambient;
+	t_camera			camera;
+	t_light				*lights;
+	int					light_count;
+	int					light_cap;
+	t_object			*objects;
+	struct s_accel		*accel;
+	struct s_bumpmap	*bumps;
+	void				*block;
+	size_t				block_size;
 }	t_scene;
 
 /* Initialize a scene with defaults and no objects. */
@@ -196,5 +241,9 @@ void	scene_init(t_scene *s);
 void	scene_free(t_scene *s);
 /* Push an object into the scene object list (O(1)). */
 void	scene_add_object(t_scene *s, t_object *obj);
+/* Append a copy of `l`; returns NULL or an error message. */
+const char	*scene_add_light(t_scene *s, const t_light *l);
+/* Move the objects and bump maps of `from` into `s`, emptying `from`. */
+void	scene_adopt(t_scene *s, t_scene *from);
 
 #endif
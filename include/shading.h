@@ -2,8 +2,9 @@
 # define SHADING_H
 
 # include "hit.h"
+# include "gbuffer.h"
 
-t_vec3	shade_lambert(const t_scene *scene, const t_hit *hit);
+t_vec3	shade_lambert(const t_scene *scene, const t_gbuf_px *px);
 int		in_shadow(const t_scene *scene, t_vec3 p, t_vec3 l_pos);
 
 #endif
\ No newline at end of file
@@ -2,9 +2,15 @@
 # define SHADING_BONUS_H
 
 # include "hit_bonus.h"
+# include "gbuffer.h"
 
-t_vec3	shade_lambert_spec(const t_scene *scene, const t_hit *hit);
+/* Lights whose estimated contribution is below this get no shadow ray. */
+# define LIGHT_CULL	0.001f
+
+t_vec3	shade_lambert_spec(const t_scene *scene, const t_gbuf_px *px);
 int		in_shadow(const t_scene *scene, t_vec3 p, t_vec3 l_pos);
 t_vec3	shade_phong(const t_scene *scene, const t_hit *hit);
+t_vec3	light_contrib(const t_scene *scene, const t_gbuf_px *px, int i);
+void	light_gather(const t_scene *scene, t_gbuf_px *px, uint32_t seed);
 
 #endif
\ No newline at end of file
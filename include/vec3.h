@@ -1,6 +1,74 @@
+/*
+* 3D vector math used everywhere on the ray path.
+* All operations are `static inline` so every translation unit can inline
+* them; out-of-line calls for a three-float add dominated the profile.
+* Building with -DVEC3_SIMD (make SIMD=1) switches t_vec3 to a 16-byte,
+* 4-lane layout backed by GCC/Clang vector extensions, which the compiler
+* maps to SSE/AVX registers. The fourth lane is padding and is ignored by
+* every reduction, so both layouts give identical results.
+*/
 #ifndef VEC3_H
 # define VEC3_H
 
+# include <math.h>
+
+# ifdef VEC3_SIMD
+
+typedef float	t_v4f __attribute__((vector_size(16)));
+
+typedef union u_vec3
+{
+	struct
+	{
+		float	x;
+		float	y;
+		float	z;
+		float	w;
+	};
+	t_v4f	v;
+}	t_vec3;
+
+/* Creates a 3D vector with components x, y, z (w lane zeroed). */
+static inline t_vec3	v3(float x, float y, float z)
+{
+	t_vec3	r;
+
+	r.v = (t_v4f){x, y, z, 0.0f};
+	return (r);
+}
+
+static inline t_vec3	v3_add(t_vec3 a, t_vec3 b)
+{
+	a.v = a.v + b.v;
+	return (a);
+}
+
+static inline t_vec3	v3_sub(t_vec3 a, t_vec3 b)
+{
+	a.v = a.v - b.v;
+	return (a);
+}
+
+static inline t_vec3	v3_mul(t_vec3 a, float s)
+{
+	a.v = a.v * s;
+	return (a);
+}
+
+static inline t_vec3	v3_div(t_vec3 a, float s)
+{
+	a.v = a.v / (t_v4f){s, s, s, 1.0f};
+	return (a);
+}
+
+static inline t_vec3	v3_ctoc(t_vec3 a, t_vec3 b)
+{
+	a.v = a.v * b.v;
+	return (a);
+}
+
+# else
+
 typedef struct s_vec3
 {
 	float	x;
@@ -8,21 +76,92 @@ typedef struct s_vec3
 	float	z;
 }	t_vec3;
 
-// Constructors
-t_vec3	v3(float x, float y, float z);
+/*
+* Creates a 3D vector with components x, y, z.
+* Useful to initialize positions, directions and colors in the 3D space.
+*/
+static inline t_vec3	v3(float x, float y, float z)
+{
+	return ((t_vec3){x, y, z});
+}
 
-// Arithmetic
-t_vec3	v3_add(t_vec3 a, t_vec3 b);
-t_vec3	v3_sub(t_vec3 a, t_vec3 b);
-t_vec3	v3_mul(t_vec3 a, float s);
-t_vec3	v3_div(t_vec3 a, float s);
+/* Useful to combine displacements or acumulate forces/colors. */
+static inline t_vec3	v3_add(t_vec3 a, t_vec3 b)
+{
+	return (v3(a.x + b.x, a.y + b.y, a.z + b.z));
+}
+
+/* Useful to obtain direction vectors between two points: b->a = a - b. */
+static inline t_vec3	v3_sub(t_vec3 a, t_vec3 b)
+{
+	return (v3(a.x - b.x, a.y - b.y, a.z - b.z));
+}
+
+/* Useful for changing the vector's lenght or interpolation. */
+static inline t_vec3	v3_mul(t_vec3 a, float s)
+{
+	return (v3(a.x * s, a.y * s, a.z * s));
+}
+
+/* Useful for normalising or converting units. */
+static inline t_vec3	v3_div(t_vec3 a, float s)
+{
+	return (v3(a.x / s, a.y / s, a.z / s));
+}
+
+/* Component to component product. */
+static inline t_vec3	v3_ctoc(t_vec3 a, t_vec3 b)
+{
+	return (v3(a.x * b.x, a.y * b.y, a.z * b.z));
+}
+
+# endif
+
+/*
+* Scalar product. Measures how much 'projection' one vector has onto another.
+* Useful for angles and shading.
+*/
+static inline float	v3_dot(t_vec3 a, t_vec3 b)
+{
+	return (a.x * b.x + a.y * b.y + a.z * b.z);
+}
+
+/*
+* Cross product: perpendicular to both vectors, following the right-hand
+* rule, with magnitude |a||b|sin(theta). Useful for orthonormal bases.
+*/
+static inline t_vec3	v3_cross(t_vec3 a, t_vec3 b)
+{
+	return (v3(
+			a.y * b.z - a.z * b.y,
+			a.z * b.x - a.x * b.z,
+			a.x * b.y - a.y * b.x));
+}
+
+/* Length squared: avoid sqrt when you only need to compare magnitudes. */
+static inline float	v3_len2(t_vec3 a)
+{
+	return (v3_dot(a, a));
+}
+
+/* Length (Euclidean norm) of the vector: sqrt(a·a). */
+static inline float	v3_len(t_vec3 a)
+{
+	return (sqrtf(v3_len2(a)));
+}
+
+/*
+* Normalisation: returns a vector with the same direction but length 1.
+* If the length is 0, returns (0,0,0) to avoid division by zero.
+*/
+static inline t_vec3	v3_norm(t_vec3 a)
+{
+	float	l;
 
-// Dot/Cross and length
-float	v3_dot(t_vec3 a, t_vec3 b);
-t_vec3	v3_ctoc(t_vec3 a, t_vec3 b);
-t_vec3	v3_cross(t_vec3 a, t_vec3 b);
-float	v3_len2(t_vec3 a);
-float	v3_len(t_vec3 a);
-t_vec3	v3_norm(t_vec3 a);
+	l = v3_len(a);
+	if (l > 0.0f)
+		return (v3_div(a, l));
+	return (v3(0.0f, 0.0f, 0.0f));
+}
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,27 @@
+/*
+* Minimal pthread fan-out used by the renderer (and any other embarrassingly
+* parallel pass). Work distribution is left to the callers: every worker runs
+* the same function over a shared context and pulls jobs from an atomic
+* counter stored inside it.
+*/
+#ifndef WORKERS_H
+# define WORKERS_H
+
+# define WORKERS_MAX 256
+
+typedef void	*(*t_worker_fn)(void *ctx);
+
+/*
+* Number of workers to use by default: MINIRT_THREADS when it holds a
+* positive integer, otherwise the number of online CPUs (clamped to
+* [1, WORKERS_MAX]).
+*/
+int		workers_default_count(void);
+/*
+* Run `fn(ctx)` on `count` threads (the caller's thread included) and wait
+* for all of them. If a thread cannot be spawned the remaining ones simply
+* take its share, so callers must not rely on an exact worker count.
+*/
+void	workers_run(int count, t_worker_fn fn, void *ctx);
+
+#endif
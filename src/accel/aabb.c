@@ -0,0 +1,101 @@
+#include <math.h>
+#include <float.h>
+#include "../../include/bvh.h"
+
+t_aabb	aabb_empty(void)
+{
+	t_aabb	box;
+
+	box.min = v3(FLT_MAX, FLT_MAX, FLT_MAX);
+	box.max = v3(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+	return (box);
+}
+/*
+* Purpose: Return an inverted box that any aabb_grow/aabb_merge overwrites.
+*/
+
+void	aabb_grow(t_aabb *box, t_vec3 p)
+{
+	box->min = v3(fminf(box->min.x, p.x), fminf(box->min.y, p.y),
+			fminf(box->min.z, p.z));
+	box->max = v3(fmaxf(box->max.x, p.x), fmaxf(box->max.y, p.y),
+			fmaxf(box->max.z, p.z));
+}
+
+void	aabb_merge(t_aabb *box, const t_aabb *other)
+{
+	box->min = v3(fminf(box->min.x, other->min.x),
+			fminf(box->min.y, other->min.y), fminf(box->min.z, other->min.z));
+	box->max = v3(fmaxf(box->max.x, other->max.x),
+			fmaxf(box->max.y, other->max.y), fmaxf(box->max.z, other->max.z));
+}
+/*
+* Purpose: Grow `box` to enclose `other`.
+* Notes: Corner-wise min/max, so merging an empty box changes nothing.
+*/
+
+void	aabb_pad(t_aabb *box)
+{
+	float	pad;
+
+	pad = 1e-4f * (1.0f + fmaxf(fmaxf(fabsf(box->min.x), fabsf(box->max.x)),
+				fmaxf(fmaxf(fabsf(box->min.y), fabsf(box->max.y)),
+					fmaxf(fabsf(box->min.z), fabsf(box->max.z)))));
+	box->min = v3_sub(box->min, v3(pad, pad, pad));
+	box->max = v3_add(box->max, v3(pad, pad, pad));
+}
+/*
+* Purpose: Inflate a box slightly so float error in the slab test never
+* culls a hit the exact primitive test would report.
+*/
+
+float	aabb_area(const t_aabb *box)
+{
+	t_vec3	d;
+
+	d = v3_sub(box->max, box->min);
+	return (d.x * d.y + d.y * d.z + d.z * d.x);
+}
+/*
+* Purpose: Half the surface area of a valid box: what the SAH weighs the
+* chance of a random ray entering it by.
+*/
+
+float	v3_axis(t_vec3 v, int axis)
+{
+	if (axis == 0)
+		return (v.x);
+	if (axis == 1)
+		return (v.y);
+	return (v.z);
+}
+
+bool	aabb_hit(const t_aabb *box, const t_bvh_ray *q, float *tnear)
+{
+	float	t0;
+	float	t1;
+	float	entry;
+	float	exit;
+
+	t0 = (box->min.x - q->r.orig.x) * q->inv_dir.x;
+	t1 = (box->max.x - q->r.orig.x) * q->inv_dir.x;
+	entry = fminf(t0, t1);
+	exit = fmaxf(t0, t1);
+	t0 = (box->min.y - q->r.orig.y) * q->inv_dir.y;
+	t1 = (box->max.y - q->r.orig.y) * q->inv_dir.y;
+	entry = fmaxf(entry, fminf(t0, t1));
+	exit = fminf(exit, fmaxf(t0, t1));
+	t0 = (box->min.z - q->r.orig.z) * q->inv_dir.z;
+	t1 = (box->max.z - q->r.orig.z) * q->inv_dir.z;
+	entry = fmaxf(entry, fminf(t0, t1));
+	exit = fminf(exit, fmaxf(t0, t1));
+	*tnear = entry;
+	return (exit >= fmaxf(entry, 0.0f) && entry <= q->tmax);
+}
+/*
+* Purpose: Slab test of the ray against the box, limited to [0, q->tmax].
+* Notes: Axis-parallel rays get +-inf in inv_dir; fminf/fmaxf drop the NaN
+* produced when the origin lies exactly on a slab plane. The comparison
+* against tmax is inclusive so hits tied with the current best still reach
+* the leaf callback.
+*/
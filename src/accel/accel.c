@@ -0,0 +1,201 @@
+#include <stdlib.h>
+#include "../../libraries/libft/libft.h"
+#include "../../include/accel.h"
+
+typedef struct s_accel_leaf
+{
+	const t_accel	*accel;
+	t_bvh_leaf		leaf;
+	void			*ctx;
+}	t_accel_leaf;
+
+typedef struct s_accel_packet
+{
+	const t_accel	*accel;
+	t_packet_leaf	other;
+}	t_accel_packet;
+
+static int	alloc_accel(t_accel *a, int count)
+{
+	size_t	n;
+
+	n = (size_t)count + 1;
+	a->count = count;
+	a->objects = (const t_object **)malloc(sizeof(t_object *) * n);
+	a->bounded = (int *)malloc(sizeof(int) * n);
+	a->planes = (int *)malloc(sizeof(int) * n);
+	a->boxes = (t_aabb *)malloc(sizeof(t_aabb) * n);
+	a->bvh_prim = (int *)malloc(sizeof(int) * n);
+	if (!a->objects || !a->bounded || !a->planes || !a->boxes || !a->bvh_prim)
+		return (-1);
+	return (0);
+}
+
+static int	classify_objects(t_accel *a, const t_object *o)
+{
+	int	id;
+	int	nb;
+
+	id = 0;
+	nb = 0;
+	while (o)
+	{
+		a->objects[id] = o;
+		a->bvh_prim[id] = -1;
+		if (object_bounds(o, &a->boxes[nb]))
+		{
+			a->bvh_prim[id] = nb;
+			a->bounded[nb++] = id;
+		}
+		else
+			a->planes[a->plane_count++] = id;
+		o = o->next;
+		id++;
+	}
+	return (nb);
+}
+/*
+* Purpose: Number the objects in list order and split them into bounded
+* ones (box written to a->boxes) and unbounded ones (planes).
+* Returns: How many bounded objects were found.
+*/
+
+int	scene_build_accel(t_scene *scene)
+{
+	t_accel			*a;
+	const t_object	*o;
+	int				count;
+
+	count = 0;
+	o = scene->objects;
+	while (o && ++count)
+		o = o->next;
+	a = (t_accel *)ft_calloc(1, sizeof(t_accel));
+	if (!a || alloc_accel(a, count) < 0
+		|| bvh_build_cached(&a->bvh, a->boxes, classify_objects(a,
+				scene->objects)) < 0
+		|| packed_build(&a->packed, a->objects, count) < 0
+		|| accel_flat_build(a) < 0)
+	{
+		accel_free(a);
+		return (-1);
+	}
+	accel_free(scene->accel);
+	scene->accel = a;
+	return (0);
+}
+/*
+* Purpose: Build the acceleration structure for an already parsed scene:
+* the BVH over bounded objects, the packed hot arrays of every object and,
+* for a small scene, its flat layout.
+* Use: Call after parse_scene succeeds; scene_free releases it.
+*/
+
+void	accel_free(t_accel *accel)
+{
+	if (!accel)
+		return ;
+	bvh_free(&accel->bvh);
+	packed_free(&accel->packed);
+	accel_flat_free(accel->flat);
+	free(accel->objects);
+	free(accel->bounded);
+	free(accel->planes);
+	free(accel->boxes);
+	free(accel->bvh_prim);
+	free(accel);
+}
+
+void	accel_update(t_accel *accel, int id)
+{
+	const t_object	*obj;
+	int				prim;
+
+	if (!accel || id < 0 || id >= accel->count)
+		return ;
+	obj = accel->objects[id];
+	if (accel->packed.refs[id].kind != PK_OTHER)
+		object_pack(&accel->packed, obj, accel->packed.refs[id].slot);
+	accel_flat_update(accel, id);
+	prim = accel->bvh_prim[id];
+	if (prim >= 0 && object_bounds(obj, &accel->boxes[prim]))
+		bvh_refit(&accel->bvh, accel->boxes, prim);
+}
+/*
+* Purpose: Bring the acceleration data of object `id` back in sync after
+* the object was moved, rotated or resized in place.
+* Logic: Its packed record is rewritten and only the BVH path from its leaf
+* up is refitted, so editing one object in a 10k-primitive scene costs a
+* few dozen box merges instead of a rebuild.
+*/
+
+static int	bounded_leaf(int id, t_bvh_ray *q, void *ctx)
+{
+	t_accel_leaf	*al;
+
+	al = (t_accel_leaf *)ctx;
+	return (al->leaf(al->accel->bounded[id], q, al->ctx));
+}
+
+void	accel_traverse(const t_accel *accel, t_bvh_ray *q, t_bvh_leaf leaf,
+		void *ctx)
+{
+	t_accel_leaf	al;
+	int				i;
+
+	i = 0;
+	while (i < accel->plane_count)
+	{
+		if (leaf(accel->planes[i++], q, ctx))
+		{
+			q->found = 1;
+			if (q->any)
+				return ;
+		}
+	}
+	if (accel->flat)
+		return (accel_flat_traverse(accel, q, leaf, ctx));
+	al.accel = accel;
+	al.leaf = leaf;
+	al.ctx = ctx;
+	bvh_traverse(&accel->bvh, q, bounded_leaf, &al);
+}
+/*
+* Purpose: Visit planes first (cheap, and usually large occluders that
+* tighten tmax early), then the bounded objects: a flat batch scan in small
+* scenes, otherwise the BVH, translating its primitive ids back to scene
+* object ids for the caller's leaf callback.
+*/
+
+static void	bounded_packet(int prim, t_packet *pk, int mask, void *ctx)
+{
+	const t_accel_packet	*ap;
+	int						id;
+
+	ap = (const t_accel_packet *)ctx;
+	id = ap->accel->bounded[prim];
+	if (!packet_packed(&ap->accel->packed, id, pk, mask))
+		ap->other(id, pk, mask, (void *)ap->accel);
+}
+
+void	accel_traverse_packet(const t_accel *accel, t_packet *pk,
+		t_packet_leaf other)
+{
+	t_accel_packet	ap;
+	int				i;
+
+	i = 0;
+	while (i < accel->plane_count)
+	{
+		if (!packet_packed(&accel->packed, accel->planes[i], pk, pk->live))
+			other(accel->planes[i], pk, pk->live, (void *)accel);
+		i++;
+	}
+	ap.accel = accel;
+	ap.other = other;
+	packet_traverse(&accel->bvh, pk, pk->live, bounded_packet, &ap);
+}
+/*
+* Purpose: accel_traverse for the live lanes of a packet: planes first, then
+* the BVH, with objects that have packed data tested 8 rays at a time.
+*/
@@ -0,0 +1,225 @@
+#include <stdlib.h>
+#include "../../libraries/libft/libft.h"
+#include "../../include/accel.h"
+
+typedef struct s_flat_walk
+{
+	const t_accel	*a;
+	t_bvh_ray		*q;
+	t_bvh_leaf		leaf;
+	void			*ctx;
+}	t_flat_walk;
+
+static bool	flat_cylinder(const t_accel *a, int id)
+{
+	return (a->objects[id]->type == OBJ_CYLINDER && a->bvh_prim[id] >= 0);
+}
+
+static int	alloc_flat(t_accel_flat *f, const t_accel *a)
+{
+	const t_packed	*p;
+	int				cyls;
+	int				id;
+
+	p = &a->packed;
+	cyls = 0;
+	id = -1;
+	while (++id < a->count)
+		cyls += flat_cylinder(a, id);
+	f->sphere_ids = (int *)malloc(sizeof(int)
+			* ((size_t)p->count[PK_SPHERE] + 1));
+	f->tri_ids = (int *)malloc(sizeof(int)
+			* ((size_t)p->count[PK_TRIANGLE] + 1));
+	f->cyl_ids = (int *)malloc(sizeof(int) * ((size_t)cyls + 1));
+	f->others = (int *)malloc(sizeof(int) * ((size_t)a->count + 1));
+	if (!f->sphere_ids || !f->tri_ids || !f->cyl_ids || !f->others
+		|| sphere_soa_init(&f->spheres, p->count[PK_SPHERE]) < 0
+		|| tri_soa_init(&f->tris, p->count[PK_TRIANGLE]) < 0
+		|| cyl_soa_init(&f->cyls, cyls) < 0)
+		return (-1);
+	f->cyls.count = 0;
+	return (0);
+}
+/*
+* Purpose: Size the flat buffers; cyls.count then counts up again as
+* accel_flat_build hands the cylinders their entries.
+*/
+
+int	accel_flat_build(t_accel *a)
+{
+	t_accel_flat	*f;
+	t_prim_ref		ref;
+	int				id;
+
+	if (a->bvh.count > ACCEL_FLAT_MAX)
+		return (0);
+	f = (t_accel_flat *)ft_calloc(1, sizeof(t_accel_flat));
+	a->flat = f;
+	if (!f || alloc_flat(f, a) < 0)
+		return (-1);
+	f->ops = batch_ops();
+	id = -1;
+	while (++id < a->count)
+	{
+		ref = a->packed.refs[id];
+		if (ref.kind == PK_SPHERE)
+			f->sphere_ids[ref.slot] = id;
+		else if (ref.kind == PK_TRIANGLE)
+			f->tri_ids[ref.slot] = id;
+		else if (flat_cylinder(a, id))
+			f->cyl_ids[f->cyls.count++] = id;
+		else if (ref.kind == PK_OTHER && a->bvh_prim[id] >= 0)
+			f->others[f->other_count++] = id;
+		accel_flat_update(a, id);
+	}
+	return (0);
+}
+/*
+* Purpose: For scenes with at most ACCEL_FLAT_MAX bounded objects, copy the
+* packed spheres and triangles into SoA buffers (entry = packed slot), the
+* cylinders into theirs, and list the other bounded objects.
+* Returns: 0 (also when the scene is too big and stays BVH-only), or -1 on
+* ENOMEM.
+*/
+
+void	accel_flat_free(t_accel_flat *f)
+{
+	if (!f)
+		return ;
+	sphere_soa_free(&f->spheres);
+	tri_soa_free(&f->tris);
+	cyl_soa_free(&f->cyls);
+	free(f->sphere_ids);
+	free(f->tri_ids);
+	free(f->cyl_ids);
+	free(f->others);
+	free(f);
+}
+
+void	accel_flat_update(t_accel *a, int id)
+{
+	t_prim_ref	ref;
+	int			i;
+
+	if (!a->flat)
+		return ;
+	ref = a->packed.refs[id];
+	if (ref.kind == PK_SPHERE)
+		sphere_soa_set(&a->flat->spheres, ref.slot,
+			&a->packed.spheres[ref.slot]);
+	else if (ref.kind == PK_TRIANGLE)
+		tri_soa_set(&a->flat->tris, ref.slot, &a->packed.tris[ref.slot]);
+	i = -1;
+	while (++i < a->flat->cyls.count)
+		if (a->flat->cyl_ids[i] == id)
+			cyl_soa_set(&a->flat->cyls, i, &a->objects[id]->u_obj.cy);
+}
+/*
+* Purpose: Copy object `id`'s current data into its flat entry; a cylinder
+* finds its entry by id (there are at most ACCEL_FLAT_MAX).
+*/
+
+static int	visit(int id, t_flat_walk *w)
+{
+	float	tnear;
+
+	if (!aabb_hit(&w->a->boxes[w->a->bvh_prim[id]], w->q, &tnear)
+		|| !w->leaf(id, w->q, w->ctx))
+		return (0);
+	w->q->found = 1;
+	return (w->q->any);
+}
+/*
+* Purpose: Hand object `id` to the caller's leaf, which recomputes and
+* accepts it exactly as on the BVH path (and records its own per-hit
+* state), provided the ray enters the object's box.
+* Notes: The box test is what the BVH would have done. Far from the
+* origin the sphere quadratic can report hits that are not there, and the
+* box is what keeps them out of the image.
+* Returns: 1 when the walk can stop (any-hit query answered).
+*/
+
+static int	offer(const int *ids, const float *t, int n, t_flat_walk *w)
+{
+	int	i;
+
+	i = -1;
+	while (++i < n)
+		if (t[i] > 0.0f && t[i] <= w->q->tmax && visit(ids[i], w))
+			return (1);
+	return (0);
+}
+
+static int	batch_len(int count, int first)
+{
+	if (count - first < BATCH_W)
+		return (count - first);
+	return (BATCH_W);
+}
+
+static int	scan_cylinders(const t_accel_flat *f, t_flat_walk *w)
+{
+	float	t[BATCH_W];
+	int		i;
+
+	i = 0;
+	while (i + FLAT_CYL_MIN <= f->cyls.count)
+	{
+		f->ops->cylinders(&f->cyls, i, w->q->r, t);
+		if (offer(f->cyl_ids + i, t, batch_len(f->cyls.count, i), w))
+			return (1);
+		i += BATCH_W;
+	}
+	while (i < f->cyls.count)
+		if (visit(f->cyl_ids[i++], w))
+			return (1);
+	return (0);
+}
+/*
+* Purpose: The cylinders' share of accel_flat_traverse.
+* Notes: A lone cylinder is cheaper behind its box than in a mostly empty
+* batch, which pays the full side and cap tests for every ray.
+*/
+
+void	accel_flat_traverse(const t_accel *a, t_bvh_ray *q, t_bvh_leaf leaf,
+		void *ctx)
+{
+	const t_accel_flat	*f;
+	t_flat_walk			w;
+	float				t[BATCH_W];
+	int					i;
+
+	f = a->flat;
+	w.a = a;
+	w.q = q;
+	w.leaf = leaf;
+	w.ctx = ctx;
+	i = 0;
+	while (i < f->spheres.count)
+	{
+		f->ops->spheres(&f->spheres, i, q->r, t);
+		if (offer(f->sphere_ids + i, t, batch_len(f->spheres.count, i), &w))
+			return ;
+		i += BATCH_W;
+	}
+	i = 0;
+	while (i < f->tris.count)
+	{
+		f->ops->tris(&f->tris, i, q->r, t);
+		if (offer(f->tri_ids + i, t, batch_len(f->tris.count, i), &w))
+			return ;
+		i += BATCH_W;
+	}
+	if (scan_cylinders(f, &w))
+		return ;
+	i = 0;
+	while (i < f->other_count)
+		if (visit(f->others[i++], &w))
+			return ;
+}
+/*
+* Purpose: Single-ray search of a small scene's bounded objects without the
+* BVH: spheres, triangles and cylinders BATCH_W at a time, the rest one by
+* one, each candidate behind its own box test.
+* Notes: Visiting order does not matter, bvh_ray_accept breaks ties by id.
+*/
@@ -0,0 +1,45 @@
+#include <math.h>
+#include "../../include/minirt.h"
+#include "../../include/accel.h"
+
+static void	sphere_bounds(const t_sphere *sp, t_aabb *out)
+{
+	float	r;
+
+	r = sp->di * 0.5f;
+	out->min = v3_sub(sp->center, v3(r, r, r));
+	out->max = v3_add(sp->center, v3(r, r, r));
+}
+
+static void	cylinder_bounds(const t_cyl *cy, t_aabb *out)
+{
+	t_vec3	a;
+	t_vec3	ext;
+	float	r;
+	float	h;
+
+	a = v3_norm(cy->axis);
+	r = cy->di * 0.5f;
+	h = cy->he * 0.5f;
+	ext.x = fabsf(a.x) * h + r * sqrtf(fmaxf(0.0f, 1.0f - a.x * a.x));
+	ext.y = fabsf(a.y) * h + r * sqrtf(fmaxf(0.0f, 1.0f - a.y * a.y));
+	ext.z = fabsf(a.z) * h + r * sqrtf(fmaxf(0.0f, 1.0f - a.z * a.z));
+	out->min = v3_sub(cy->center, ext);
+	out->max = v3_add(cy->center, ext);
+}
+/*
+* Purpose: Tight box of a capped cylinder: the two cap disks each extend
+* r * sqrt(1 - axis_i^2) along world axis i around their centres.
+*/
+
+int	object_bounds(const t_object *obj, t_aabb *out)
+{
+	if (obj->type == OBJ_SPHERE)
+		sphere_bounds(&obj->u_obj.sp, out);
+	else if (obj->type == OBJ_CYLINDER)
+		cylinder_bounds(&obj->u_obj.cy, out);
+	else
+		return (0);
+	aabb_pad(out);
+	return (1);
+}
@@ -0,0 +1,82 @@
+#include <math.h>
+#include "../../include/minirt.h"
+#include "../../include/accel.h"
+#include "../../include/mesh_bonus.h"
+
+static void	sphere_bounds(const t_sphere *sp, t_aabb *out)
+{
+	float	r;
+
+	r = sp->di * 0.5f;
+	out->min = v3_sub(sp->center, v3(r, r, r));
+	out->max = v3_add(sp->center, v3(r, r, r));
+}
+
+static void	cylinder_bounds(const t_cyl *cy, t_aabb *out)
+{
+	t_vec3	a;
+	t_vec3	ext;
+	float	r;
+	float	h;
+
+	a = v3_norm(cy->axis);
+	r = cy->di * 0.5f;
+	h = cy->he * 0.5f;
+	ext.x = fabsf(a.x) * h + r * sqrtf(fmaxf(0.0f, 1.0f - a.x * a.x));
+	ext.y = fabsf(a.y) * h + r * sqrtf(fmaxf(0.0f, 1.0f - a.y * a.y));
+	ext.z = fabsf(a.z) * h + r * sqrtf(fmaxf(0.0f, 1.0f - a.z * a.z));
+	out->min = v3_sub(cy->center, ext);
+	out->max = v3_add(cy->center, ext);
+}
+/*
+* Purpose: Tight box of a capped cylinder: the two cap disks each extend
+* r * sqrt(1 - axis_i^2) along world axis i around their centres.
+*/
+
+static void	triangle_bounds(const t_triangle *tr, t_aabb *out)
+{
+	*out = aabb_empty();
+	aabb_grow(out, tr->a);
+	aabb_grow(out, tr->b);
+	aabb_grow(out, tr->c);
+}
+
+static void	hparab_bounds(const t_hparab *hp, t_aabb *out)
+{
+	t_vec3	ext;
+	float	rx;
+	float	ry;
+	float	hh;
+
+	rx = hp->rx * 1.0001f;
+	ry = hp->ry * 1.0001f;
+	hh = hp->half_height + 2e-4f;
+	ext.x = fabsf(hp->u.x) * rx + fabsf(hp->v.x) * ry + fabsf(hp->axis.x) * hh;
+	ext.y = fabsf(hp->u.y) * rx + fabsf(hp->v.y) * ry + fabsf(hp->axis.y) * hh;
+	ext.z = fabsf(hp->u.z) * rx + fabsf(hp->v.z) * ry + fabsf(hp->axis.z) * hh;
+	out->min = v3_sub(hp->center, ext);
+	out->max = v3_add(hp->center, ext);
+}
+/*
+* Purpose: Box of the clipped saddle: hit_hparaboloid only accepts points
+* inside the rx/ry ellipse and within half_height along the axis, so the
+* local box [-rx,rx] x [-ry,ry] x [-hh,hh] bounds it (tolerances included).
+*/
+
+int	object_bounds(const t_object *obj, t_aabb *out)
+{
+	if (obj->type == OBJ_SPHERE)
+		sphere_bounds(&obj->u_obj.sp, out);
+	else if (obj->type == OBJ_CYLINDER)
+		cylinder_bounds(&obj->u_obj.cy, out);
+	else if (obj->type == OBJ_TRIANGLE)
+		triangle_bounds(&obj->u_obj.tr, out);
+	else if (obj->type == OBJ_HPARABOLOID)
+		hparab_bounds(&obj->u_obj.hp, out);
+	else if (obj->type == OBJ_MESH)
+		*out = obj->u_obj.me.data->bvh.nodes[0].box;
+	else
+		return (0);
+	aabb_pad(out);
+	return (1);
+}
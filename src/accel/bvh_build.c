@@ -0,0 +1,230 @@
+#include <stdlib.h>
+#include <sys/mman.h>
+#include "../../libraries/libft/libft.h"
+#include "../../include/bvh_internal.h"
+#include "../../include/workers.h"
+
+static void	push_task(t_bvh_builder *b, int slot, t_bvh_range r)
+{
+	t_bvh_task	*grown;
+
+	if (b->task_count == b->task_cap)
+	{
+		b->task_cap = b->task_cap * 2 + 16;
+		grown = (t_bvh_task *)malloc(sizeof(t_bvh_task)
+				* (size_t)b->task_cap);
+		if (!grown)
+		{
+			b->failed = 1;
+			return ;
+		}
+		if (b->task_count)
+			ft_memcpy(grown, b->tasks, sizeof(t_bvh_task)
+				* (size_t)b->task_count);
+		free(b->tasks);
+		b->tasks = grown;
+	}
+	b->tasks[b->task_count].slot = slot;
+	b->tasks[b->task_count].range = r;
+	b->tasks[b->task_count].out.nodes = NULL;
+	b->tasks[b->task_count].out.count = 0;
+	b->task_count++;
+}
+
+static void	build_node(t_bvh_builder *b, t_bvh_out *out, int node,
+		t_bvh_range r)
+{
+	t_bvh_node	*n;
+	t_bvh_range	child;
+	t_aabb		cbox;
+	int			mid;
+
+	if (b->pool && r.count <= BVH_TASK_SIZE)
+	{
+		push_task(b, node, r);
+		return ;
+	}
+	n = &out->nodes[node];
+	n->box = aabb_empty();
+	cbox = aabb_empty();
+	mid = r.first;
+	while (mid < r.first + r.count)
+	{
+		aabb_merge(&n->box, &b->prims[mid].box);
+		aabb_grow(&cbox, b->prims[mid++].centroid);
+	}
+	n->first = r.first;
+	n->count = r.count;
+	mid = bvh_split(b, r, &cbox);
+	if (mid < 0)
+		return ;
+	n->first = out->count;
+	n->count = 0;
+	out->count += 2;
+	child.first = r.first;
+	child.count = mid - r.first;
+	child.depth = r.depth + 1;
+	build_node(b, out, n->first, child);
+	child.first = mid;
+	child.count = r.first + r.count - mid;
+	build_node(b, out, n->first + 1, child);
+}
+/*
+* Purpose: Recursively build the subtree over `r` with its root at
+* out->nodes[node].
+* Logic: bvh_split picks the split (or a leaf). Children are appended as a
+* pair so an inner node only needs the index of its left child. In the
+* serial top pass (b->pool), subtrees small enough for one task are only
+* recorded; their root node is filled in later.
+*/
+
+static void	*task_worker(void *ctx)
+{
+	t_bvh_builder	*b;
+	t_bvh_task		*t;
+	int				i;
+
+	b = (t_bvh_builder *)ctx;
+	i = atomic_fetch_add(&b->next, 1);
+	while (i < b->task_count)
+	{
+		t = &b->tasks[i];
+		t->out.nodes = (t_bvh_node *)malloc(sizeof(t_bvh_node)
+				* (size_t)t->range.count * 2);
+		t->out.count = 1;
+		if (t->out.nodes)
+			build_node(b, &t->out, 0, t->range);
+		i = atomic_fetch_add(&b->next, 1);
+	}
+	return (NULL);
+}
+
+static void	stitch_task(t_bvh *bvh, t_bvh_task *t)
+{
+	t_bvh_node	*n;
+	int			base;
+	int			i;
+
+	base = bvh->node_count - 1;
+	i = -1;
+	while (++i < t->out.count)
+	{
+		n = &bvh->nodes[base + i];
+		if (i == 0)
+			n = &bvh->nodes[t->slot];
+		*n = t->out.nodes[i];
+		if (n->count == 0)
+			n->first += base;
+	}
+	bvh->node_count += t->out.count - 1;
+}
+/*
+* Purpose: Move a finished subtree into the final array: its root into the
+* slot the top pass left for it, the other nodes appended, their child
+* links shifted to match.
+*/
+
+static void	run_tasks(t_bvh_builder *b, t_bvh *bvh)
+{
+	int	threads;
+	int	i;
+
+	b->pool = 0;
+	atomic_init(&b->next, 0);
+	threads = workers_default_count();
+	if (threads > b->task_count)
+		threads = b->task_count;
+	if (threads > 0)
+		workers_run(threads, task_worker, b);
+	i = -1;
+	while (++i < b->task_count)
+	{
+		if (!b->tasks[i].out.nodes)
+			b->failed = 1;
+		else if (!b->failed)
+			stitch_task(bvh, &b->tasks[i]);
+		free(b->tasks[i].out.nodes);
+	}
+	free(b->tasks);
+}
+/*
+* Purpose: Build the subtrees set aside by the top pass on the worker
+* threads, then stitch them in task order.
+* Notes: Task order is fixed by the top pass, so the final node layout is
+* the same whatever the thread count.
+*/
+
+int	bvh_build(t_bvh *bvh, const t_aabb *boxes, int count)
+{
+	t_bvh_builder	b;
+	t_bvh_out		top;
+	t_bvh_range		root;
+	int				i;
+
+	ft_bzero(bvh, sizeof(*bvh));
+	bvh->count = count;
+	if (count <= 0)
+		return (0);
+	ft_bzero(&b, sizeof(b));
+	bvh->nodes = (t_bvh_node *)malloc(sizeof(t_bvh_node) * (size_t)count * 2);
+	bvh->index = (int *)malloc(sizeof(int) * (size_t)count);
+	b.prims = (t_bvh_prim *)malloc(sizeof(t_bvh_prim) * (size_t)count);
+	if (!bvh->nodes || !bvh->index || !b.prims)
+		return (free(b.prims), bvh_free(bvh), -1);
+	i = -1;
+	while (++i < count)
+	{
+		b.prims[i].box = boxes[i];
+		b.prims[i].centroid = v3_mul(v3_add(boxes[i].min, boxes[i].max), 0.5f);
+		b.prims[i].id = i;
+	}
+	b.pool = (count > BVH_TASK_SIZE);
+	root.first = 0;
+	root.count = count;
+	root.depth = 0;
+	top.nodes = bvh->nodes;
+	top.count = 1;
+	build_node(&b, &top, 0, root);
+	bvh->node_count = top.count;
+	run_tasks(&b, bvh);
+	i = -1;
+	while (++i < count)
+		bvh->index[i] = b.prims[i].id;
+	free(b.prims);
+	if (b.failed || bvh_link(bvh) < 0 || bvh_widen(bvh) < 0)
+		return (bvh_free(bvh), -1);
+	return (0);
+}
+/*
+* Purpose: Build a BVH over `count` boxes; primitive ids are 0..count-1.
+* Logic: A serial pass splits the top of the tree until the subtrees fit
+* BVH_TASK_SIZE; those are built in parallel as pool tasks (see run_tasks).
+* Notes: A binary tree with N leaves-worth of primitives never needs more than
+* 2N - 1 nodes, so the node array is allocated once up front.
+*/
+
+void	bvh_free(t_bvh *bvh)
+{
+	if (bvh->map)
+		munmap(bvh->map, bvh->map_size);
+	else
+	{
+		free(bvh->nodes);
+		free(bvh->index);
+	}
+	free(bvh->parent);
+	free(bvh->leaf_of);
+	free(bvh->wide);
+	free(bvh->wide_slot);
+	bvh->nodes = NULL;
+	bvh->index = NULL;
+	bvh->parent = NULL;
+	bvh->leaf_of = NULL;
+	bvh->map = NULL;
+	bvh->map_size = 0;
+	bvh->wide = NULL;
+	bvh->wide_slot = NULL;
+	bvh->wide_count = 0;
+	bvh->node_count = 0;
+	bvh->count = 0;
+}
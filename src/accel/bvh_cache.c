@@ -0,0 +1,179 @@
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "../../libraries/libft/libft.h"
+#include "../../include/bvh.h"
+#include "../../include/hash.h"
+
+/* "BVH1" read as a little-endian word. */
+#define BVH_CACHE_MAGIC	0x31485642u
+
+/*
+* Cache file: this header, then t_bvh_node[node_count], then int[count]
+* (the leaf-order primitive ids), all in host byte order. It is named after
+* `key`, the hash of the boxes the tree was built over, so any scene with
+* the same primitives (e.g. animation frames that only move the camera)
+* finds it. parent and leaf_of are not stored: they follow from the nodes.
+*/
+typedef struct s_bvh_file
+{
+	uint32_t	magic;
+	uint32_t	version;
+	uint32_t	node_size;
+	uint32_t	leaf_max;
+	int32_t		count;
+	int32_t		node_count;
+	uint64_t	key;
+}	t_bvh_file;
+
+static char	*cache_path(uint64_t key, int create)
+{
+	const char	*dir;
+	char		name[22];
+	int			i;
+
+	dir = getenv("MINIRT_BVH_CACHE");
+	if (!dir || !*dir)
+		return (NULL);
+	if (create)
+		mkdir(dir, 0755);
+	name[0] = '/';
+	i = 0;
+	while (i++ < 16)
+		name[i] = "0123456789abcdef"[(key >> (64 - 4 * i)) & 15];
+	ft_strlcpy(name + 17, ".bvh", 5);
+	return (ft_strjoin(dir, name));
+}
+/*
+* Purpose: <MINIRT_BVH_CACHE>/<key as 16 hex digits>.bvh, creating the
+* directory (one level) before a save.
+* Returns: NULL when the variable is unset or empty, i.e. caching is off,
+* or on ENOMEM.
+*/
+
+static int	cache_load(t_bvh *bvh, const char *path, uint64_t key, int count)
+{
+	struct stat			st;
+	const t_bvh_file	*h;
+	int					fd;
+
+	fd = open(path, O_RDONLY);
+	if (fd < 0)
+		return (-1);
+	bvh->map = NULL;
+	if (fstat(fd, &st) == 0 && st.st_size >= (off_t)sizeof(t_bvh_file))
+		bvh->map = mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE,
+				MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (!bvh->map || bvh->map == MAP_FAILED)
+		return (bvh->map = NULL, -1);
+	bvh->map_size = (size_t)st.st_size;
+	h = (const t_bvh_file *)bvh->map;
+	if (h->magic != BVH_CACHE_MAGIC || h->version != BVH_CACHE_VERSION
+		|| h->node_size != sizeof(t_bvh_node) || h->leaf_max != BVH_LEAF_MAX
+		|| h->key != key || h->count != count || h->node_count < 1
+		|| h->node_count >= 2 * count || bvh->map_size != sizeof(t_bvh_file)
+		+ sizeof(t_bvh_node) * (size_t)h->node_count
+		+ sizeof(int) * (size_t)count)
+		return (-1);
+	bvh->nodes = (t_bvh_node *)(h + 1);
+	bvh->node_count = h->node_count;
+	bvh->index = (int *)(bvh->nodes + h->node_count);
+	if (bvh_link(bvh) < 0)
+		return (-1);
+	return (bvh_widen(bvh));
+}
+/*
+* Purpose: Map a cached tree in place of building it.
+* Notes: The mapping is private and writable, so bvh_refit can update the
+* boxes of edited objects without touching the file.
+* Returns: 0 on a hit; -1 when the file is missing, stale or damaged (the
+* caller frees whatever was set up).
+*/
+
+static int	write_all(int fd, const void *data, size_t size)
+{
+	ssize_t	n;
+
+	while (size > 0)
+	{
+		n = write(fd, data, size);
+		if (n <= 0)
+			return (-1);
+		data = (const char *)data + n;
+		size -= (size_t)n;
+	}
+	return (0);
+}
+
+static void	cache_save(const t_bvh *bvh, const char *path, uint64_t key)
+{
+	t_bvh_file	h;
+	char		*tmp;
+	int			fd;
+	int			err;
+
+	ft_bzero(&h, sizeof(h));
+	h.magic = BVH_CACHE_MAGIC;
+	h.version = BVH_CACHE_VERSION;
+	h.node_size = sizeof(t_bvh_node);
+	h.leaf_max = BVH_LEAF_MAX;
+	h.count = bvh->count;
+	h.node_count = bvh->node_count;
+	h.key = key;
+	tmp = ft_strjoin(path, ".tmp");
+	fd = -1;
+	if (tmp)
+		fd = open(tmp, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (fd < 0)
+		return (free(tmp));
+	err = (write_all(fd, &h, sizeof(h)) < 0
+			|| write_all(fd, bvh->nodes, sizeof(t_bvh_node)
+				* (size_t)bvh->node_count) < 0
+			|| write_all(fd, bvh->index, sizeof(int) * (size_t)bvh->count) < 0);
+	if (close(fd) < 0 || err || rename(tmp, path) < 0)
+		unlink(tmp);
+	free(tmp);
+}
+/*
+* Purpose: Store a freshly built tree, best effort.
+* Notes: Written under a temporary name and renamed into place, so a
+* concurrent run never maps a half-written file.
+*/
+
+int	bvh_build_cached(t_bvh *bvh, const t_aabb *boxes, int count)
+{
+	uint64_t	key;
+	char		*path;
+
+	if (count < BVH_CACHE_MIN)
+		return (bvh_build(bvh, boxes, count));
+	key = hash_words(HASH_SEED, boxes, sizeof(t_aabb) * (size_t)count);
+	ft_bzero(bvh, sizeof(*bvh));
+	bvh->count = count;
+	path = cache_path(key, 0);
+	if (path && cache_load(bvh, path, key, count) == 0)
+		return (free(path), 0);
+	free(path);
+	bvh_free(bvh);
+	if (bvh_build(bvh, boxes, count) < 0)
+		return (-1);
+	path = cache_path(key, 1);
+	if (path)
+		cache_save(bvh, path, key);
+	free(path);
+	return (0);
+}
+/*
+* Purpose: Get the BVH of `boxes`, from the cache when these exact boxes
+* were built before, otherwise by building it and caching the result.
+* Notes: Opt-in: without MINIRT_BVH_CACHE every tree is built, as before.
+* It suits static scenes rendered again and again. Small sets skip the
+* cache (see BVH_CACHE_MIN). The key covers every box bit for bit, so any
+* change to the primitives means a new file; old files are never pruned,
+* so the directory is the user's to clear.
+*/
@@ -0,0 +1,60 @@
+#include "../../include/bvh.h"
+
+static t_aabb	node_box(const t_bvh *bvh, const t_bvh_node *n,
+		const t_aabb *boxes)
+{
+	t_aabb	box;
+	int		i;
+
+	if (n->count == 0)
+	{
+		box = bvh->nodes[n->first].box;
+		aabb_merge(&box, &bvh->nodes[n->first + 1].box);
+		return (box);
+	}
+	box = aabb_empty();
+	i = n->first;
+	while (i < n->first + n->count)
+		aabb_merge(&box, &boxes[bvh->index[i++]]);
+	return (box);
+}
+/*
+* Purpose: Box of node `n` recomputed from its content: the primitive
+* boxes of a leaf, or the union of the two children of an inner node.
+*/
+
+static bool	aabb_equal(const t_aabb *a, const t_aabb *b)
+{
+	return (a->min.x == b->min.x && a->min.y == b->min.y
+		&& a->min.z == b->min.z && a->max.x == b->max.x
+		&& a->max.y == b->max.y && a->max.z == b->max.z);
+}
+
+void	bvh_refit(t_bvh *bvh, const t_aabb *boxes, int prim)
+{
+	t_bvh_node	*n;
+	t_aabb		box;
+	int			node;
+
+	if (prim < 0 || prim >= bvh->count || !bvh->leaf_of)
+		return ;
+	node = bvh->leaf_of[prim];
+	while (node >= 0)
+	{
+		n = &bvh->nodes[node];
+		box = node_box(bvh, n, boxes);
+		if (aabb_equal(&box, &n->box))
+			return ;
+		n->box = box;
+		bvh_wide_refit(bvh, node);
+		node = bvh->parent[node];
+	}
+}
+/*
+* Purpose: Update the tree after primitive `prim` changed its box (already
+* written to boxes[prim]), touching only the leaf that holds it and the
+* ancestors whose box actually changes, in both the binary and the wide
+* layout.
+* Notes: The topology is kept, so a primitive moved far away leaves a
+* looser tree than a rebuild would; boxes stay exact, so hits are the same.
+*/
@@ -0,0 +1,209 @@
+#include <float.h>
+#include "../../include/bvh_internal.h"
+
+/*
+* Centroids of one node dropped into BVH_BINS slices along `axis`: the bin
+* of centroid c is (c[axis] - lo) * scale.
+* split, cost: best plane found so far; bins 0..split go left (-1 while
+* no plane separates the node).
+*/
+typedef struct s_bvh_binning
+{
+	t_aabb	box[BVH_BINS];
+	int		count[BVH_BINS];
+	int		axis;
+	float	lo;
+	float	scale;
+	int		split;
+	float	cost;
+}	t_bvh_binning;
+
+static void	swap_prims(t_bvh_prim *prims, int a, int b)
+{
+	t_bvh_prim	tmp;
+
+	tmp = prims[a];
+	prims[a] = prims[b];
+	prims[b] = tmp;
+}
+
+static int	bin_of(const t_bvh_binning *bn, t_vec3 c)
+{
+	int	bin;
+
+	bin = (int)((v3_axis(c, bn->axis) - bn->lo) * bn->scale);
+	if (bin < 0)
+		return (0);
+	if (bin >= BVH_BINS)
+		return (BVH_BINS - 1);
+	return (bin);
+}
+
+static void	select_nth(const t_bvh_builder *b, t_bvh_range r, int nth,
+		int axis)
+{
+	float	pivot;
+	int		lt;
+	int		i;
+	int		gt;
+
+	while (r.count > 1)
+	{
+		pivot = v3_axis(b->prims[r.first + r.count / 2].centroid, axis);
+		lt = r.first;
+		i = r.first;
+		gt = r.first + r.count;
+		while (i < gt)
+		{
+			if (v3_axis(b->prims[i].centroid, axis) < pivot)
+				swap_prims(b->prims, lt++, i++);
+			else if (v3_axis(b->prims[i].centroid, axis) > pivot)
+				swap_prims(b->prims, i, --gt);
+			else
+				i++;
+		}
+		if (nth >= lt && nth < gt)
+			return ;
+		if (nth < lt)
+			r.count = lt - r.first;
+		else
+		{
+			r.count -= gt - r.first;
+			r.first = gt;
+		}
+	}
+}
+/*
+* Purpose: Partially order prims over `r` so that prims[nth] is the
+* primitive with the nth smallest centroid on `axis` (quickselect).
+* Notes: Three-way partitioning keeps runs of equal centroids (flat meshes,
+* duplicated triangles) linear instead of quadratic.
+*/
+
+static void	fill_bins(const t_bvh_builder *b, t_bvh_range r, t_bvh_binning *bn)
+{
+	int		bin;
+	int		i;
+
+	bin = -1;
+	while (++bin < BVH_BINS)
+	{
+		bn->box[bin] = aabb_empty();
+		bn->count[bin] = 0;
+	}
+	i = r.first - 1;
+	while (++i < r.first + r.count)
+	{
+		bin = bin_of(bn, b->prims[i].centroid);
+		aabb_merge(&bn->box[bin], &b->prims[i].box);
+		bn->count[bin]++;
+	}
+}
+
+static void	sweep_bins(t_bvh_binning *bn, int total)
+{
+	float	right[BVH_BINS];
+	t_aabb	box;
+	int		n;
+	int		i;
+
+	box = aabb_empty();
+	n = 0;
+	i = BVH_BINS;
+	while (--i > 0)
+	{
+		aabb_merge(&box, &bn->box[i]);
+		n += bn->count[i];
+		right[i] = 0.0f;
+		if (n > 0)
+			right[i] = aabb_area(&box) * (float)n;
+	}
+	box = aabb_empty();
+	n = 0;
+	while (i < BVH_BINS - 1)
+	{
+		aabb_merge(&box, &bn->box[i]);
+		n += bn->count[i];
+		if (n > 0 && n < total
+			&& aabb_area(&box) * (float)n + right[i + 1] < bn->cost)
+		{
+			bn->cost = aabb_area(&box) * (float)n + right[i + 1];
+			bn->split = i;
+		}
+		i++;
+	}
+}
+/*
+* Purpose: Price every plane between two bins as
+* area(left) * count(left) + area(right) * count(right), keeping the
+* cheapest one that leaves primitives on both sides.
+*/
+
+static int	partition(const t_bvh_builder *b, t_bvh_range r,
+		const t_bvh_binning *bn)
+{
+	int	lo;
+	int	hi;
+
+	lo = r.first;
+	hi = r.first + r.count;
+	while (lo < hi)
+	{
+		if (bin_of(bn, b->prims[lo].centroid) <= bn->split)
+			lo++;
+		else
+			swap_prims(b->prims, lo, --hi);
+	}
+	return (lo);
+}
+
+static int	widest_axis(t_vec3 ext)
+{
+	if (ext.x >= ext.y && ext.x >= ext.z)
+		return (0);
+	if (ext.y >= ext.z)
+		return (1);
+	return (2);
+}
+
+int	bvh_split(const t_bvh_builder *b, t_bvh_range r, const t_aabb *cbox)
+{
+	t_bvh_binning	bn;
+	t_vec3			ext;
+	int				mid;
+
+	ext = v3_sub(cbox->max, cbox->min);
+	if (r.count <= BVH_LEAF_MAX
+		|| (ext.x <= 0.0f && ext.y <= 0.0f && ext.z <= 0.0f))
+		return (-1);
+	bn.axis = widest_axis(ext);
+	mid = -1;
+	if (r.depth < BVH_SAH_DEPTH)
+	{
+		bn.lo = v3_axis(cbox->min, bn.axis);
+		bn.scale = (float)BVH_BINS / v3_axis(ext, bn.axis);
+		bn.cost = FLT_MAX;
+		bn.split = -1;
+		fill_bins(b, r, &bn);
+		sweep_bins(&bn, r.count);
+		if (bn.split >= 0)
+			mid = partition(b, r, &bn);
+	}
+	if (mid > r.first && mid < r.first + r.count)
+		return (mid);
+	mid = r.first + r.count / 2;
+	select_nth(b, r, mid, bn.axis);
+	return (mid);
+}
+/*
+* Purpose: Split a node the way the surface area heuristic prefers.
+* Notes: Primitives move as whole records, so every pass over a node reads
+* memory in order instead of chasing ids into the caller's box array.
+* Logic: Binned SAH along the widest axis of the centroid bounds `cbox`:
+* the centroids are dropped into BVH_BINS bins and the cheapest plane
+* between bins wins (see sweep_bins). Binning one axis instead of three
+* costs a few percent of tree quality for a third of the work. Nodes
+* deeper than BVH_SAH_DEPTH, or that no bin plane separates, are split at
+* the median instead, as the old builder did everywhere; a node whose
+* centroids all coincide stays a leaf.
+*/
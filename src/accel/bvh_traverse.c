@@ -0,0 +1,265 @@
+#include <stddef.h>
+#include "../../include/bvh.h"
+
+void	bvh_ray_init(t_bvh_ray *q, t_ray r, float tmax, int any)
+{
+	q->r = r;
+	q->inv_dir = v3(1.0f / r.dir.x, 1.0f / r.dir.y, 1.0f / r.dir.z);
+	q->tmax = tmax;
+	q->best = -1;
+	q->any = any;
+	q->found = 0;
+}
+
+bool	bvh_ray_accept(t_bvh_ray *q, float t, int id)
+{
+	if (t > q->tmax)
+		return (false);
+	if (t == q->tmax && (q->best < 0 || id > q->best))
+		return (false);
+	q->tmax = t;
+	q->best = id;
+	return (true);
+}
+/*
+* Purpose: Record a candidate hit at distance `t` if it beats the current one.
+* Logic: Strictly closer hits always win; exact ties go to the lower id. Ids
+* follow the scene's object order, so the winner is exactly the one a plain
+* front-to-back scan of the object list would have kept, whatever order the
+* tree visits the primitives in.
+*/
+
+/* BVH_WIDE lanes of floats / of lane masks: one slot per lane. */
+typedef float	t_fw __attribute__((vector_size(BVH_WIDE * sizeof(float))));
+typedef int		t_iw __attribute__((vector_size(BVH_WIDE * sizeof(int))));
+
+/*
+* Stack entries are wide nodes (ref >= 0) or leaf slots
+* (ref = -1 - (node * BVH_WIDE + slot)), each with where the ray enters it.
+*/
+typedef struct s_bvh_walk
+{
+	t_bvh_leaf	leaf;
+	t_bvh_span	span;
+	void		*ctx;
+	int			depth;
+	int			ref[BVH_WIDE_STACK];
+	float		tnear[BVH_WIDE_STACK];
+}	t_bvh_walk;
+
+static inline t_fw	fw_pick(t_iw m, t_fw a, t_fw b)
+{
+	return ((t_fw)(((t_iw)a & m) | ((t_iw)b & ~m)));
+}
+/*
+* Purpose: a where m is set, b elsewhere. fw_pick(a < b | b != b, a, b) is
+* a lane-wise fminf (a NaN operand loses), likewise fmaxf with a > b.
+*/
+
+static inline int	fw_bits(t_iw m, int used)
+{
+	int	bits;
+	int	i;
+
+	bits = 0;
+	i = -1;
+	while (++i < used)
+		if (m[i])
+			bits |= 1 << i;
+	return (bits);
+}
+/*
+* Purpose: Lane masks of the first `used` lanes as a bit set (empty slots
+* are never reported, whatever their boxes hold).
+*/
+
+static inline void	slab_axis(const t_bvh_wide *w, int axis, float o,
+		float inv, t_fw *t)
+{
+	t_fw	lo;
+	t_fw	hi;
+
+	__builtin_memcpy(&lo, w->box[axis], sizeof(lo));
+	__builtin_memcpy(&hi, w->box[axis + 3], sizeof(hi));
+	t[0] = (lo - o) * inv;
+	t[1] = (hi - o) * inv;
+	t[2] = fw_pick((t[0] < t[1]) | (t[1] != t[1]), t[0], t[1]);
+	t[3] = fw_pick((t[0] > t[1]) | (t[1] != t[1]), t[0], t[1]);
+}
+
+static int	slab_wide(const t_bvh_wide *w, const t_bvh_ray *q, float *tnear)
+{
+	t_fw	t[4];
+	t_fw	entry;
+	t_fw	exit;
+	t_iw	hit;
+
+	slab_axis(w, 0, q->r.orig.x, q->inv_dir.x, t);
+	entry = t[2];
+	exit = t[3];
+	slab_axis(w, 1, q->r.orig.y, q->inv_dir.y, t);
+	entry = fw_pick((entry > t[2]) | (t[2] != t[2]), entry, t[2]);
+	exit = fw_pick((exit < t[3]) | (t[3] != t[3]), exit, t[3]);
+	slab_axis(w, 2, q->r.orig.z, q->inv_dir.z, t);
+	entry = fw_pick((entry > t[2]) | (t[2] != t[2]), entry, t[2]);
+	exit = fw_pick((exit < t[3]) | (t[3] != t[3]), exit, t[3]);
+	hit = (exit >= fw_pick(entry > 0.0f, entry, (t_fw){0}))
+		& (entry <= q->tmax);
+	__builtin_memcpy(tnear, &entry, sizeof(entry));
+	return (fw_bits(hit, w->used));
+}
+/*
+* Purpose: aabb_hit against every slot of `w` at once, lane for lane the
+* same arithmetic, so both accept exactly the same boxes.
+* Returns: A bit per slot whose box the ray enters; entry distances go to
+* tnear[].
+*/
+
+static int	visit_leaf(const t_bvh *bvh, int ref, t_bvh_ray *q, t_bvh_walk *w)
+{
+	const t_bvh_wide	*n;
+	int					slot;
+	int					i;
+
+	n = &bvh->wide[(-1 - ref) / BVH_WIDE];
+	slot = (-1 - ref) % BVH_WIDE;
+	if (w->span)
+	{
+		if (!w->span(n->first[slot], n->count[slot], q, w->ctx))
+			return (0);
+		q->found = 1;
+		return (q->any);
+	}
+	i = n->first[slot];
+	while (i < n->first[slot] + n->count[slot])
+	{
+		if (w->leaf(bvh->index[i], q, w->ctx))
+		{
+			q->found = 1;
+			if (q->any)
+				return (1);
+		}
+		i++;
+	}
+	return (0);
+}
+
+static void	push(t_bvh_walk *w, int ref, float tnear)
+{
+	if (w->depth >= BVH_WIDE_STACK)
+		return ;
+	w->ref[w->depth] = ref;
+	w->tnear[w->depth] = tnear;
+	w->depth++;
+}
+
+static void	sort_near_first(int *slot, int n, const float *tnear)
+{
+	int	i;
+	int	j;
+	int	s;
+
+	i = 0;
+	while (++i < n)
+	{
+		s = slot[i];
+		j = i;
+		while (j > 0 && tnear[slot[j - 1]] > tnear[s])
+		{
+			slot[j] = slot[j - 1];
+			j--;
+		}
+		slot[j] = s;
+	}
+}
+
+static void	push_slots(const t_bvh *bvh, int node, t_bvh_ray *q,
+		t_bvh_walk *w)
+{
+	const t_bvh_wide	*n;
+	float				tnear[BVH_WIDE];
+	int					slot[BVH_WIDE];
+	int					bits;
+	int					count;
+
+	n = &bvh->wide[node];
+	bits = slab_wide(n, q, tnear);
+	count = 0;
+	while (bits)
+	{
+		slot[count++] = __builtin_ctz(bits);
+		bits &= bits - 1;
+	}
+	if (!q->any)
+		sort_near_first(slot, count, tnear);
+	while (count-- > 0)
+	{
+		if (n->count[slot[count]] == 0)
+			push(w, n->first[slot[count]], tnear[slot[count]]);
+		else
+			push(w, -1 - (node * BVH_WIDE + slot[count]), tnear[slot[count]]);
+	}
+}
+/*
+* Purpose: Push the slots of wide node `node` whose boxes the ray enters.
+* Logic: Closest-hit rays sort the slots nearest first and push them in
+* reverse, so the nearest slot is popped next and its hits prune the rest;
+* any-hit rays stop at the first accepted hit wherever it is, so they skip
+* the sort.
+*/
+
+static void	walk(const t_bvh *bvh, t_bvh_ray *q, t_bvh_walk *w)
+{
+	int	ref;
+
+	if (bvh->wide_count == 0)
+		return ;
+	w->depth = 0;
+	push(w, 0, 0.0f);
+	while (w->depth > 0)
+	{
+		w->depth--;
+		if (w->tnear[w->depth] > q->tmax)
+			continue ;
+		ref = w->ref[w->depth];
+		if (ref >= 0)
+			push_slots(bvh, ref, q, w);
+		else if (visit_leaf(bvh, ref, q, w))
+			return ;
+	}
+}
+/*
+* Purpose: Walk the collapsed tree front to back and hand candidate
+* primitives to the walk's leaf or span callback, which intersects them and
+* shrinks q->tmax on accepted hits.
+* Notes: Each stack entry remembers where the ray enters its box, so
+* subtrees that lie behind a hit found in the meantime are skipped on pop.
+* The root needs no test of its own: its slots are tested as it is visited.
+*/
+
+void	bvh_traverse(const t_bvh *bvh, t_bvh_ray *q, t_bvh_leaf leaf,
+		void *ctx)
+{
+	t_bvh_walk	w;
+
+	w.leaf = leaf;
+	w.span = NULL;
+	w.ctx = ctx;
+	walk(bvh, q, &w);
+}
+
+void	bvh_traverse_spans(const t_bvh *bvh, t_bvh_ray *q, t_bvh_span span,
+		void *ctx)
+{
+	t_bvh_walk	w;
+
+	w.leaf = NULL;
+	w.span = span;
+	w.ctx = ctx;
+	walk(bvh, q, &w);
+}
+/*
+* Purpose: Same walk, handing each leaf over whole (positions
+* first .. first + count of bvh->index) so the caller can test its
+* primitives together when it keeps them in leaf order.
+*/
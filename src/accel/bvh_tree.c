@@ -0,0 +1,116 @@
+#include <stdlib.h>
+#include "../../libraries/libft/libft.h"
+#include "../../include/bvh.h"
+
+static int	link_leaf(t_bvh *bvh, int node, int *seen)
+{
+	const t_bvh_node	*n;
+	int					i;
+	int					id;
+
+	n = &bvh->nodes[node];
+	if (n->first < 0 || n->count > bvh->count - n->first)
+		return (-1);
+	i = n->first;
+	while (i < n->first + n->count)
+	{
+		id = bvh->index[i++];
+		if (id < 0 || id >= bvh->count || bvh->leaf_of[id] >= 0)
+			return (-1);
+		bvh->leaf_of[id] = node;
+		(*seen)++;
+	}
+	return (0);
+}
+
+int	bvh_link(t_bvh *bvh)
+{
+	const t_bvh_node	*n;
+	int					i;
+	int					seen;
+
+	bvh->parent = (int *)malloc(sizeof(int) * (size_t)bvh->node_count);
+	bvh->leaf_of = (int *)malloc(sizeof(int) * (size_t)bvh->count);
+	if (!bvh->parent || !bvh->leaf_of)
+		return (-1);
+	ft_memset(bvh->leaf_of, 0xff, sizeof(int) * (size_t)bvh->count);
+	bvh->parent[0] = -1;
+	seen = 0;
+	i = -1;
+	while (++i < bvh->node_count)
+	{
+		n = &bvh->nodes[i];
+		if (n->count > 0 && link_leaf(bvh, i, &seen) < 0)
+			return (-1);
+		if (n->count > 0)
+			continue ;
+		if (n->count < 0 || n->first <= i || n->first >= bvh->node_count - 1)
+			return (-1);
+		bvh->parent[n->first] = i;
+		bvh->parent[n->first + 1] = i;
+	}
+	return (-(seen != bvh->count));
+}
+/*
+* Purpose: Fill parent and leaf_of from the node array, checking on the
+* way that it is a tree bvh_build could have made: children after their
+* parent and in range, leaves inside index, every primitive in exactly one
+* leaf. A damaged cache file is then rejected instead of walked.
+* Returns: 0, or -1 on ENOMEM or a malformed tree (arrays left to
+* bvh_free).
+*/
+
+static void	add_node(const t_bvh *bvh, int i, const int *depth,
+		t_bvh_stats *st)
+{
+	const t_bvh_node	*n;
+	float				area;
+
+	n = &bvh->nodes[i];
+	area = aabb_area(&n->box);
+	if (n->count == 0)
+		st->sah_cost += BVH_SAH_TRAVERSE * area;
+	else
+	{
+		st->leaves++;
+		st->sah_cost += BVH_SAH_INTERSECT * area * (float)n->count;
+	}
+	if (depth && depth[i] > st->depth)
+		st->depth = depth[i];
+}
+
+void	bvh_stats(const t_bvh *bvh, t_bvh_stats *st)
+{
+	int		*depth;
+	float	root;
+	int		i;
+
+	ft_bzero(st, sizeof(*st));
+	if (bvh->node_count <= 0)
+		return ;
+	st->nodes = bvh->node_count;
+	depth = (int *)malloc(sizeof(int) * (size_t)bvh->node_count);
+	if (depth)
+		depth[0] = 0;
+	i = -1;
+	while (++i < bvh->node_count)
+	{
+		if (depth && i > 0)
+			depth[i] = depth[bvh->parent[i]] + 1;
+		add_node(bvh, i, depth, st);
+	}
+	free(depth);
+	root = aabb_area(&bvh->nodes[0].box);
+	if (root > 0.0f)
+		st->sah_cost /= root;
+	else
+		st->sah_cost = 0.0f;
+}
+/*
+* Purpose: Measure a built tree: node and leaf counts, depth (root = 0) and
+* SAH cost.
+* Logic: Parents come before their children in the node array, so one
+* pass over it assigns every depth. Each node's cost is weighted by its
+* area relative to the root's, the chance that a random ray reaching the
+* root also enters it.
+*/
@@ -0,0 +1,120 @@
+#include <stdlib.h>
+#include "../../libraries/libft/libft.h"
+#include "../../include/bvh.h"
+
+static int	gather(const t_bvh *bvh, int root, int *kids)
+{
+	const t_bvh_node	*n;
+	float				best;
+	int					open;
+	int					count;
+	int					i;
+
+	kids[0] = root;
+	count = 1;
+	best = 0.0f;
+	while (count < BVH_WIDE)
+	{
+		open = -1;
+		i = -1;
+		while (++i < count)
+		{
+			n = &bvh->nodes[kids[i]];
+			if (n->count == 0 && (open < 0 || aabb_area(&n->box) > best))
+			{
+				open = i;
+				best = aabb_area(&n->box);
+			}
+		}
+		if (open < 0)
+			break ;
+		n = &bvh->nodes[kids[open]];
+		kids[open] = n->first;
+		kids[count++] = n->first + 1;
+	}
+	return (count);
+}
+/*
+* Purpose: Pick the binary nodes that become the slots of one wide node:
+* start from `root` and keep opening the largest inner node among them
+* until BVH_WIDE are collected or only leaves remain.
+* Returns: How many slots were filled.
+*/
+
+static void	set_box(t_bvh_wide *w, int slot, const t_aabb *box)
+{
+	w->box[0][slot] = box->min.x;
+	w->box[1][slot] = box->min.y;
+	w->box[2][slot] = box->min.z;
+	w->box[3][slot] = box->max.x;
+	w->box[4][slot] = box->max.y;
+	w->box[5][slot] = box->max.z;
+}
+
+static int	widen_node(t_bvh *bvh, int root)
+{
+	const t_bvh_node	*n;
+	int					kids[BVH_WIDE];
+	int					node;
+	int					i;
+
+	node = bvh->wide_count++;
+	ft_bzero(&bvh->wide[node], sizeof(t_bvh_wide));
+	bvh->wide[node].used = gather(bvh, root, kids);
+	i = -1;
+	while (++i < bvh->wide[node].used)
+	{
+		n = &bvh->nodes[kids[i]];
+		set_box(&bvh->wide[node], i, &n->box);
+		bvh->wide_slot[kids[i]] = node * BVH_WIDE + i;
+		bvh->wide[node].count[i] = n->count;
+		bvh->wide[node].first[i] = n->first;
+		if (n->count == 0)
+			bvh->wide[node].first[i] = widen_node(bvh, kids[i]);
+	}
+	return (node);
+}
+/*
+* Purpose: Emit the wide node for the subtree under binary node `root`,
+* then, depth first, the wide nodes of its inner slots.
+* Returns: Its index in bvh->wide.
+*/
+
+int	bvh_widen(t_bvh *bvh)
+{
+	free(bvh->wide);
+	free(bvh->wide_slot);
+	bvh->wide_count = 0;
+	bvh->wide = NULL;
+	bvh->wide_slot = NULL;
+	if (bvh->node_count <= 0)
+		return (0);
+	bvh->wide = (t_bvh_wide *)malloc(sizeof(t_bvh_wide)
+			* ((size_t)bvh->node_count / 2 + 1));
+	bvh->wide_slot = (int *)malloc(sizeof(int) * (size_t)bvh->node_count);
+	if (!bvh->wide || !bvh->wide_slot)
+		return (-1);
+	ft_memset(bvh->wide_slot, 0xff, sizeof(int) * (size_t)bvh->node_count);
+	widen_node(bvh, 0);
+	return (0);
+}
+/*
+* Purpose: Build the collapsed tree single rays walk.
+* Notes: Every wide node stands for a distinct inner binary node (or the
+* root leaf), so node_count / 2 + 1 of them always suffice. The binary tree
+* is kept: packets walk it, bvh_refit updates it and the cache stores it.
+*/
+
+void	bvh_wide_refit(t_bvh *bvh, int node)
+{
+	int	slot;
+
+	if (!bvh->wide_slot || bvh->wide_slot[node] < 0)
+		return ;
+	slot = bvh->wide_slot[node];
+	set_box(&bvh->wide[slot / BVH_WIDE], slot % BVH_WIDE,
+		&bvh->nodes[node].box);
+}
+/*
+* Purpose: Copy binary node `node`'s box, just refitted, into its wide slot.
+*/
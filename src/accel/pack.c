@@ -0,0 +1,32 @@
+#include "../../include/minirt.h"
+#include "../../include/accel.h"
+
+int	object_pack_kind(const t_object *obj)
+{
+	if (obj->type == OBJ_SPHERE)
+		return (PK_SPHERE);
+	if (obj->type == OBJ_PLANE)
+		return (PK_PLANE);
+	return (PK_OTHER);
+}
+/*
+* Purpose: Which packed array `obj` goes to; cylinders keep using the full
+* object (their test needs nearly every field anyway).
+*/
+
+void	object_pack(t_packed *p, const t_object *obj, int slot)
+{
+	float	r;
+
+	if (obj->type == OBJ_SPHERE)
+	{
+		r = obj->u_obj.sp.di * 0.5f;
+		p->spheres[slot].center = obj->u_obj.sp.center;
+		p->spheres[slot].r2 = r * r;
+	}
+	else if (obj->type == OBJ_PLANE)
+	{
+		p->planes[slot].point = obj->u_obj.pl.point;
+		p->planes[slot].normal = obj->u_obj.pl.normal;
+	}
+}
@@ -0,0 +1,43 @@
+#include "../../include/minirt.h"
+#include "../../include/accel.h"
+
+int	object_pack_kind(const t_object *obj)
+{
+	if (obj->type == OBJ_SPHERE)
+		return (PK_SPHERE);
+	if (obj->type == OBJ_PLANE)
+		return (PK_PLANE);
+	if (obj->type == OBJ_TRIANGLE)
+		return (PK_TRIANGLE);
+	return (PK_OTHER);
+}
+/*
+* Purpose: Which packed array `obj` goes to. Cylinders and paraboloids need
+* nearly every field for their test and meshes already keep their own flat
+* buffers, so those stay on the generic path.
+*/
+
+void	object_pack(t_packed *p, const t_object *obj, int slot)
+{
+	const t_triangle	*tr;
+	float				r;
+
+	if (obj->type == OBJ_SPHERE)
+	{
+		r = obj->u_obj.sp.di * 0.5f;
+		p->spheres[slot].center = obj->u_obj.sp.center;
+		p->spheres[slot].r2 = r * r;
+	}
+	else if (obj->type == OBJ_PLANE)
+	{
+		p->planes[slot].point = obj->u_obj.pl.point;
+		p->planes[slot].normal = obj->u_obj.pl.normal;
+	}
+	else if (obj->type == OBJ_TRIANGLE)
+	{
+		tr = &obj->u_obj.tr;
+		p->tris[slot].a = tr->a;
+		p->tris[slot].e1 = tr->e1;
+		p->tris[slot].e2 = tr->e2;
+	}
+}
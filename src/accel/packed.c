@@ -0,0 +1,152 @@
+#include <stdlib.h>
+#include "../../libraries/libft/libft.h"
+#include "../../include/packed.h"
+
+static int	alloc_packed(t_packed *p)
+{
+	p->spheres = (t_sphere_hot *)malloc(sizeof(t_sphere_hot)
+			* ((size_t)p->count[PK_SPHERE] + 1));
+	p->planes = (t_plane_hot *)malloc(sizeof(t_plane_hot)
+			* ((size_t)p->count[PK_PLANE] + 1));
+	p->tris = (t_tri_hot *)malloc(sizeof(t_tri_hot)
+			* ((size_t)p->count[PK_TRIANGLE] + 1));
+	if (!p->spheres || !p->planes || !p->tris)
+		return (-1);
+	return (0);
+}
+
+int	packed_build(t_packed *p, const struct s_object **objects, int count)
+{
+	int	id;
+	int	kind;
+
+	ft_bzero(p, sizeof(*p));
+	p->refs = (t_prim_ref *)malloc(sizeof(t_prim_ref) * ((size_t)count + 1));
+	if (!p->refs)
+		return (-1);
+	id = -1;
+	while (++id < count)
+	{
+		kind = object_pack_kind(objects[id]);
+		p->refs[id].kind = kind;
+		p->refs[id].slot = p->count[kind]++;
+	}
+	if (alloc_packed(p) < 0)
+		return (packed_free(p), -1);
+	id = -1;
+	while (++id < count)
+		if (p->refs[id].kind != PK_OTHER)
+			object_pack(p, objects[id], p->refs[id].slot);
+	return (0);
+}
+/*
+* Purpose: Compile the id-ordered object table into per-kind hot arrays.
+* Logic: A first pass assigns every id its slot in its kind's array, so each
+* array is allocated once at its exact size; a second pass copies the data.
+*/
+
+void	packed_free(t_packed *p)
+{
+	free(p->refs);
+	free(p->spheres);
+	free(p->planes);
+	free(p->tris);
+	ft_bzero(p, sizeof(*p));
+}
+
+static float	sphere_hot_t(const t_sphere_hot *sp, t_ray r)
+{
+	t_vec3	oc;
+	float	a;
+	float	half_b;
+	float	disc;
+	float	t;
+
+	oc = v3_sub(r.orig, sp->center);
+	a = v3_dot(r.dir, r.dir);
+	half_b = v3_dot(oc, r.dir);
+	disc = half_b * half_b - a * (v3_dot(oc, oc) - sp->r2);
+	if (disc < 0.0f)
+		return (-1.0f);
+	t = (-half_b - sqrtf(disc)) / a;
+	if (t > 0.0f)
+		return (t);
+	t = (-half_b + sqrtf(disc)) / a;
+	if (t > 0.0f)
+		return (t);
+	return (-1.0f);
+}
+
+static float	plane_hot_t(const t_plane_hot *pl, t_ray r)
+{
+	float	den;
+	float	t;
+
+	den = v3_dot(pl->normal, r.dir);
+	if (fabsf(den) < 1e-6f)
+		return (-1.0f);
+	t = v3_dot(v3_sub(pl->point, r.orig), pl->normal) / den;
+	if (t > 0.0f)
+		return (t);
+	return (-1.0f);
+}
+
+typedef struct s_tri_aux
+{
+	t_vec3	pvec;
+	t_vec3	tvec;
+	t_vec3	qvec;
+	float	inv_det;
+	float	u;
+	float	v;
+}	t_tri_aux;
+
+float	tri_hot_t(const t_tri_hot *tr, t_ray r)
+{
+	t_tri_aux	x;
+	float		t;
+
+	x.pvec = v3_cross(r.dir, tr->e2);
+	x.inv_det = v3_dot(tr->e1, x.pvec);
+	if (fabsf(x.inv_det) < 1e-8f)
+		return (-1.0f);
+	x.inv_det = 1.0f / x.inv_det;
+	x.tvec = v3_sub(r.orig, tr->a);
+	x.u = v3_dot(x.tvec, x.pvec) * x.inv_det;
+	if (x.u < 0.0f || x.u > 1.0f)
+		return (-1.0f);
+	x.qvec = v3_cross(x.tvec, tr->e1);
+	x.v = v3_dot(r.dir, x.qvec) * x.inv_det;
+	if (x.v < 0.0f || (x.u + x.v) > 1.0f)
+		return (-1.0f);
+	t = v3_dot(tr->e2, x.qvec) * x.inv_det;
+	if (t > 0.0f)
+		return (t);
+	return (-1.0f);
+}
+/*
+* Purpose: Moller-Trumbore on precomputed edges; shared by packed scene
+* triangles and mesh triangles.
+*/
+
+bool	packed_t(const t_packed *p, int id, t_ray r, float *t)
+{
+	t_prim_ref	ref;
+
+	ref = p->refs[id];
+	if (ref.kind == PK_SPHERE)
+		*t = sphere_hot_t(&p->spheres[ref.slot], r);
+	else if (ref.kind == PK_PLANE)
+		*t = plane_hot_t(&p->planes[ref.slot], r);
+	else if (ref.kind == PK_TRIANGLE)
+		*t = tri_hot_t(&p->tris[ref.slot], r);
+	else
+		return (false);
+	return (true);
+}
+/*
+* Purpose: Distance test straight from the packed arrays.
+* Notes: Each test performs exactly the float operations of hit_sphere,
+* hit_plane and hit_triangle on the same values, so it returns the same
+* distances bit for bit.
+*/
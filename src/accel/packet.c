@@ -0,0 +1,80 @@
+#include <stddef.h>
+#include "../../include/packet.h"
+
+void	packet_init(t_packet *pk, const t_ray *rays, int count, float tmax)
+{
+	t_ray	r;
+	int		i;
+
+	i = -1;
+	while (++i < PACKET_W)
+	{
+		r = rays[0];
+		if (i < count)
+			r = rays[i];
+		bvh_ray_init(&pk->q[i], r, tmax, 0);
+		pk->ox[i] = r.orig.x;
+		pk->oy[i] = r.orig.y;
+		pk->oz[i] = r.orig.z;
+		pk->dx[i] = r.dir.x;
+		pk->dy[i] = r.dir.y;
+		pk->dz[i] = r.dir.z;
+		pk->ix[i] = pk->q[i].inv_dir.x;
+		pk->iy[i] = pk->q[i].inv_dir.y;
+		pk->iz[i] = pk->q[i].inv_dir.z;
+		pk->tmax[i] = tmax;
+		pk->ctx[i] = NULL;
+	}
+	pk->live = (1 << count) - 1;
+}
+/*
+* Purpose: Load up to PACKET_W rays. Missing lanes repeat the first ray so
+* the vector maths stays finite; they are simply never set in `live`.
+*/
+
+bool	packet_accept(t_packet *pk, int lane, float t, int id)
+{
+	if (!bvh_ray_accept(&pk->q[lane], t, id))
+		return (false);
+	pk->q[lane].found = 1;
+	pk->tmax[lane] = t;
+	return (true);
+}
+/*
+* Purpose: bvh_ray_accept for one lane, keeping the vector copy of tmax in
+* step with the lane's scalar state.
+*/
+
+void	packet_scalar(t_packet *pk, int mask, t_bvh_leaf leaf, int id)
+{
+	int	i;
+
+	while (mask)
+	{
+		i = __builtin_ctz(mask);
+		mask &= mask - 1;
+		if (leaf(id, &pk->q[i], pk->ctx[i]))
+		{
+			pk->q[i].found = 1;
+			pk->tmax[i] = pk->q[i].tmax;
+		}
+	}
+}
+/*
+* Purpose: Per-lane fallback for primitives without a vector kernel: the
+* scalar leaf runs on the lane's own t_bvh_ray and context, then the
+* vector copy of tmax is refreshed.
+*/
+
+int	packet_lane_count(int mask)
+{
+	int	n;
+
+	n = 0;
+	while (mask)
+	{
+		mask &= mask - 1;
+		n++;
+	}
+	return (n);
+}
@@ -0,0 +1,124 @@
+#include <math.h>
+#include "../../include/minirt.h"
+#include "../../include/packet.h"
+
+static void	store(t_f8 t, t_i8 miss, float *out)
+{
+	t = f8_select(miss, (t_f8){0} - 1.0f, t);
+	__builtin_memcpy(out, &t, sizeof(t));
+}
+
+void	packet_sphere(const t_sphere_hot *sp, const t_packet *pk, float *t)
+{
+	t_f8	oc[3];
+	t_f8	a;
+	t_f8	half_b;
+	t_f8	disc;
+	t_f8	root;
+	int		i;
+
+	oc[0] = pk->ox - sp->center.x;
+	oc[1] = pk->oy - sp->center.y;
+	oc[2] = pk->oz - sp->center.z;
+	a = pk->dx * pk->dx + pk->dy * pk->dy + pk->dz * pk->dz;
+	half_b = oc[0] * pk->dx + oc[1] * pk->dy + oc[2] * pk->dz;
+	disc = half_b * half_b - a * ((oc[0] * oc[0] + oc[1] * oc[1]
+				+ oc[2] * oc[2]) - sp->r2);
+	root = disc;
+	i = -1;
+	while (++i < PACKET_W)
+		root[i] = sqrtf(disc[i]);
+	oc[0] = (-half_b - root) / a;
+	oc[1] = (-half_b + root) / a;
+	store(f8_select(oc[0] > 0.0f, oc[0], oc[1]),
+		(disc < 0.0f) | (~(oc[0] > 0.0f) & ~(oc[1] > 0.0f)), t);
+}
+/*
+* Purpose: sphere_hot_t on 8 rays: nearest root in front of the origin.
+*/
+
+void	packet_plane(const t_plane_hot *pl, const t_packet *pk, float *t)
+{
+	t_f8	den;
+	t_f8	dist;
+
+	den = pl->normal.x * pk->dx + pl->normal.y * pk->dy
+		+ pl->normal.z * pk->dz;
+	dist = ((pl->point.x - pk->ox) * pl->normal.x
+			+ (pl->point.y - pk->oy) * pl->normal.y
+			+ (pl->point.z - pk->oz) * pl->normal.z) / den;
+	store(dist, ((den < 1e-6f) & (den > -1e-6f)) | ~(dist > 0.0f), t);
+}
+/*
+* Purpose: plane_hot_t on 8 rays; |den| < 1e-6 is written as a two-sided
+* compare, which is also false for NaN like the scalar fabsf test.
+*/
+
+void	packet_tri(const t_tri_hot *tr, const t_packet *pk, float *t)
+{
+	t_f8	p[3];
+	t_f8	s[3];
+	t_f8	inv_det;
+	t_f8	u;
+	t_i8	miss;
+
+	p[0] = pk->dy * tr->e2.z - pk->dz * tr->e2.y;
+	p[1] = pk->dz * tr->e2.x - pk->dx * tr->e2.z;
+	p[2] = pk->dx * tr->e2.y - pk->dy * tr->e2.x;
+	inv_det = tr->e1.x * p[0] + tr->e1.y * p[1] + tr->e1.z * p[2];
+	miss = (inv_det < 1e-8f) & (inv_det > -1e-8f);
+	inv_det = 1.0f / inv_det;
+	s[0] = pk->ox - tr->a.x;
+	s[1] = pk->oy - tr->a.y;
+	s[2] = pk->oz - tr->a.z;
+	u = (s[0] * p[0] + s[1] * p[1] + s[2] * p[2]) * inv_det;
+	miss |= (u < 0.0f) | (u > 1.0f);
+	p[0] = s[1] * tr->e1.z - s[2] * tr->e1.y;
+	p[1] = s[2] * tr->e1.x - s[0] * tr->e1.z;
+	p[2] = s[0] * tr->e1.y - s[1] * tr->e1.x;
+	s[0] = (pk->dx * p[0] + pk->dy * p[1] + pk->dz * p[2]) * inv_det;
+	miss |= (s[0] < 0.0f) | ((u + s[0]) > 1.0f);
+	s[0] = (tr->e2.x * p[0] + tr->e2.y * p[1] + tr->e2.z * p[2]) * inv_det;
+	store(s[0], miss | ~(s[0] > 0.0f), t);
+}
+/*
+* Purpose: tri_hot_t (Moller-Trumbore) on 8 rays.
+* Logic: Every lane runs the whole test and the early exits of the scalar
+* version become one miss mask; pvec and qvec share p[], tvec, v and t
+* share s[].
+*/
+
+void	packet_offer(t_packet *pk, int mask, const float *t, int id)
+{
+	int	i;
+
+	while (mask)
+	{
+		i = __builtin_ctz(mask);
+		mask &= mask - 1;
+		if (t[i] > EPSILON)
+			packet_accept(pk, i, t[i], id);
+	}
+}
+
+bool	packet_packed(const t_packed *p, int id, t_packet *pk, int mask)
+{
+	t_prim_ref	ref;
+	float		t[PACKET_W];
+
+	ref = p->refs[id];
+	if (ref.kind == PK_OTHER)
+		return (false);
+	if (ref.kind == PK_SPHERE)
+		packet_sphere(&p->spheres[ref.slot], pk, t);
+	else if (ref.kind == PK_PLANE)
+		packet_plane(&p->planes[ref.slot], pk, t);
+	else
+		packet_tri(&p->tris[ref.slot], pk, t);
+	packet_offer(pk, mask, t, id);
+	return (true);
+}
+/*
+* Purpose: Packet counterpart of packed_t + bvh_ray_accept: test object
+* `id` from its hot data and let each lane in `mask` keep a closer hit.
+*/
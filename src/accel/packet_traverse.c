@@ -0,0 +1,154 @@
+#include "../../include/packet.h"
+
+/*
+* Shared traversal stack: one entry per subtree, with the lanes that still
+* need it and where each of them enters its box.
+*/
+typedef struct s_packet_walk
+{
+	t_packet_leaf	leaf;
+	void			*ctx;
+	int				depth;
+	int				node[BVH_STACK];
+	int				mask[BVH_STACK];
+	t_f8			tnear[BVH_STACK];
+}	t_packet_walk;
+
+static int	packet_box(const t_aabb *b, const t_packet *pk, t_f8 *tnear)
+{
+	t_f8	t0;
+	t_f8	t1;
+	t_f8	entry;
+	t_f8	exit;
+
+	t0 = (b->min.x - pk->ox) * pk->ix;
+	t1 = (b->max.x - pk->ox) * pk->ix;
+	entry = f8_min(t0, t1);
+	exit = f8_max(t0, t1);
+	t0 = (b->min.y - pk->oy) * pk->iy;
+	t1 = (b->max.y - pk->oy) * pk->iy;
+	entry = f8_max(entry, f8_min(t0, t1));
+	exit = f8_min(exit, f8_max(t0, t1));
+	t0 = (b->min.z - pk->oz) * pk->iz;
+	t1 = (b->max.z - pk->oz) * pk->iz;
+	entry = f8_max(entry, f8_min(t0, t1));
+	exit = f8_min(exit, f8_max(t0, t1));
+	*tnear = entry;
+	return (i8_bits((exit >= f8_max(entry, (t_f8){0})) & (entry <= pk->tmax)));
+}
+/*
+* Purpose: aabb_hit for the 8 lanes at once, with the same operations, so
+* each lane gets exactly the answer its scalar test would give.
+*/
+
+static void	push(t_packet_walk *w, int node, int mask, t_f8 tnear)
+{
+	if (w->depth >= BVH_STACK || !mask)
+		return ;
+	w->node[w->depth] = node;
+	w->mask[w->depth] = mask;
+	w->tnear[w->depth] = tnear;
+	w->depth++;
+}
+
+static void	push_single(const t_bvh *bvh, const t_bvh_node *n, t_packet *pk,
+		t_packet_walk *w)
+{
+	int		lane;
+	float	t[2];
+	bool	hit[2];
+	t_f8	tl;
+	t_f8	tr;
+
+	lane = __builtin_ctz(w->mask[w->depth]);
+	hit[0] = aabb_hit(&bvh->nodes[n->first].box, &pk->q[lane], &t[0]);
+	hit[1] = aabb_hit(&bvh->nodes[n->first + 1].box, &pk->q[lane], &t[1]);
+	tl = (t_f8){0};
+	tr = tl;
+	tl[lane] = t[0];
+	tr[lane] = t[1];
+	if (hit[0] && hit[1] && t[1] < t[0])
+	{
+		push(w, n->first, 1 << lane, tl);
+		push(w, n->first + 1, 1 << lane, tr);
+		return ;
+	}
+	if (hit[1])
+		push(w, n->first + 1, 1 << lane, tr);
+	if (hit[0])
+		push(w, n->first, 1 << lane, tl);
+}
+/*
+* Purpose: Children of a node only one ray still needs: the packet has
+* diverged there, so fall back to that ray's scalar box test.
+*/
+
+static void	push_children(const t_bvh *bvh, const t_bvh_node *n, t_packet *pk,
+		t_packet_walk *w)
+{
+	int		mask;
+	int		ml;
+	int		mr;
+	t_f8	tl;
+	t_f8	tr;
+
+	mask = w->mask[w->depth];
+	if (!(mask & (mask - 1)))
+		return (push_single(bvh, n, pk, w));
+	ml = packet_box(&bvh->nodes[n->first].box, pk, &tl) & mask;
+	mr = packet_box(&bvh->nodes[n->first + 1].box, pk, &tr) & mask;
+	if (2 * packet_lane_count(i8_bits(tr < tl) & ml & mr)
+		> packet_lane_count(ml & mr))
+	{
+		push(w, n->first, ml, tl);
+		push(w, n->first + 1, mr, tr);
+		return ;
+	}
+	push(w, n->first + 1, mr, tr);
+	push(w, n->first, ml, tl);
+}
+/*
+* Purpose: Push the children the remaining lanes enter, the one most of
+* them reach first on top.
+*/
+
+void	packet_traverse(const t_bvh *bvh, t_packet *pk, int mask,
+		t_packet_leaf leaf, void *ctx)
+{
+	t_packet_walk		w;
+	const t_bvh_node	*n;
+	t_f8				tnear;
+	int					i;
+
+	if (bvh->node_count == 0)
+		return ;
+	w.leaf = leaf;
+	w.ctx = ctx;
+	w.depth = 0;
+	mask &= packet_box(&bvh->nodes[0].box, pk, &tnear);
+	push(&w, 0, mask, tnear);
+	while (w.depth > 0)
+	{
+		w.depth--;
+		w.mask[w.depth] &= ~i8_bits(w.tnear[w.depth] > pk->tmax);
+		if (!w.mask[w.depth])
+			continue ;
+		n = &bvh->nodes[w.node[w.depth]];
+		if (n->count == 0)
+			push_children(bvh, n, pk, &w);
+		else
+		{
+			i = n->first;
+			while (i < n->first + n->count)
+				leaf(bvh->index[i++], pk, w.mask[w.depth], ctx);
+		}
+	}
+}
+/*
+* Purpose: bvh_traverse for a packet: one front-to-back walk shared by all
+* lanes in `mask`, each subtree carrying the lanes whose ray enters it.
+* Notes: A lane drops out of a subtree on the same tests its scalar walk
+* uses (box missed, or entered beyond that lane's tmax). The visiting order
+* may differ from the scalar one, which bvh_ray_accept's tie rule makes
+* irrelevant to the result.
+*/
@@ -0,0 +1,100 @@
+#include "../../include/minirt.h"
+#include "../../include/cli.h"
+#include "../../include/image_write.h"
+
+static int	parse_dim(const char **s, int *out)
+{
+	long	n;
+
+	n = 0;
+	if (**s < '0' || **s > '9')
+		return (-1);
+	while (**s >= '0' && **s <= '9')
+	{
+		n = n * 10 + (**s - '0');
+		if (n > CLI_MAX_DIM)
+			return (-1);
+		(*s)++;
+	}
+	if (n < 1)
+		return (-1);
+	*out = (int)n;
+	return (0);
+}
+
+int	cli_parse_size(const char *s, int *width, int *height)
+{
+	if (parse_dim(&s, width) < 0 || (*s != 'x' && *s != 'X'))
+		return (-1);
+	s++;
+	if (parse_dim(&s, height) < 0 || *s != '\0')
+		return (-1);
+	return (0);
+}
+/*
+* Purpose: Parse a "WxH" frame size, each side in [1, CLI_MAX_DIM].
+*/
+
+static int	parse_option(char **av, int *i, t_cli *cli)
+{
+	if (!av[*i + 1])
+		return (-1);
+	if (ft_strcmp(av[*i], "--output") == 0)
+		cli->output = av[*i + 1];
+	else if (ft_strcmp(av[*i], "--size") == 0)
+	{
+		if (cli_parse_size(av[*i + 1], &cli->width, &cli->height) < 0)
+			return (-1);
+	}
+	else
+		return (-1);
+	*i += 2;
+	return (0);
+}
+
+int	cli_parse(int ac, char **av, t_cli *cli)
+{
+	int	i;
+
+	cli->scene_path = NULL;
+	cli->output = NULL;
+	cli->width = WIN_W;
+	cli->height = WIN_H;
+	i = 1;
+	while (i < ac)
+	{
+		if (av[i][0] == '-' && av[i][1] == '-')
+		{
+			if (parse_option(av, &i, cli) < 0)
+				return (-1);
+		}
+		else if (cli->scene_path)
+			return (-1);
+		else
+			cli->scene_path = av[i++];
+	}
+	if (!cli->scene_path)
+		return (-1);
+	if (cli->output && image_format(cli->output) == IMG_UNKNOWN)
+		return (-1);
+	return (0);
+}
+/*
+* Purpose: Read `<scene.rt> [--output file] [--size WxH]` in any order.
+* Notes: Without --output the frame is shown in an MLX window as before.
+* A scene path of "-" is read from standard input.
+*/
+
+void	cli_usage(const char *prog)
+{
+	ft_putstr_fd((char *)"Usage: ", 2);
+	if (prog)
+		ft_putstr_fd((char *)prog, 2);
+	ft_putstr_fd((char *)" <scene.rt|-> [--output out.ppm|out.png]"
+		" [--size WxH]\n", 2);
+	ft_putstr_fd((char *)"Environment:\n"
+		"  MINIRT_BVH_CACHE=<dir>  keep the BVHs of large scenes in <dir>"
+		" and reuse them\n"
+		"                          on later runs (off when unset; never"
+		" pruned)\n", 2);
+}
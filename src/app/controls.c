@@ -0,0 +1,183 @@
+#include "../../include/minirt.h"
+#include "../../include/app.h"
+#include "../../include/camera.h"
+#include "../../include/render.h"
+#include "../../include/hit.h"
+#include "../../include/accel.h"
+#include "../../include/ui.h"
+
+static void	edited(t_app *app)
+{
+	t_cam_frame	fr;
+
+	if (app->sel.target == TARGET_OBJECT)
+		accel_update(app->scene.accel, app->sel.id);
+	if (app->sel.target == TARGET_CAMERA && app->overlay.visible)
+	{
+		camera_build_frame(&app->scene.camera, app->width, app->height, &fr);
+		ti_show_axes(&app->overlay, &fr);
+	}
+	render_moved(app);
+}
+/*
+* Purpose: Common tail of every edit: refit the edited object's BVH path,
+* keep the axes overlay in sync with the camera and restart the
+* progressive render from its coarse pass.
+*/
+
+static float	move_step(const t_app *app)
+{
+	const t_accel	*a;
+	t_aabb			box;
+
+	a = app->scene.accel;
+	if (!a || a->bvh.node_count == 0)
+		return (1.0f);
+	box = a->bvh.nodes[0].box;
+	return (MOVE_FRACTION * fmaxf(v3_len(v3_sub(box.max, box.min)), 1.0f));
+}
+/*
+* Purpose: Translation per key press, relative to the size of the scene so
+* the same keys work for a room and for a table-top model.
+*/
+
+static void	apply_move(t_app *app, t_vec3 d)
+{
+	if (app->sel.target == TARGET_CAMERA)
+		app->scene.camera.pos = v3_add(app->scene.camera.pos, d);
+	else if (app->sel.target == TARGET_LIGHT)
+		app->scene.lights[app->sel.id].pos = v3_add(
+				app->scene.lights[app->sel.id].pos, d);
+	else if (!object_translate(app->sel.obj, d))
+		return ;
+	edited(app);
+}
+
+static void	apply_turn(t_app *app, t_vec3 axis, float deg)
+{
+	t_camera	*cam;
+
+	if (app->sel.target == TARGET_CAMERA)
+	{
+		cam = &app->scene.camera;
+		cam->dir = v3_norm(v3_rotate(cam->dir, axis, deg2rad(deg)));
+	}
+	else if (app->sel.target == TARGET_LIGHT
+		|| !object_rotate(app->sel.obj, axis, deg2rad(deg)))
+		return ;
+	edited(app);
+}
+/*
+* Purpose: Turn the camera's view direction or the selected object's
+* orientation around a screen axis; a point light has nothing to turn.
+*/
+
+static float	sign(keys_t key, keys_t negative)
+{
+	if (key == negative)
+		return (-1.0f);
+	return (1.0f);
+}
+
+bool	controls_key(t_app *app, keys_t key)
+{
+	t_cam_frame	fr;
+	float		s;
+
+	if (key == MLX_KEY_C)
+		app->sel.target = TARGET_CAMERA;
+	else if (key == MLX_KEY_L && app->sel.target == TARGET_LIGHT)
+		app->sel.id = (app->sel.id + 1) % app->scene.light_count;
+	else if (key == MLX_KEY_L)
+	{
+		app->sel.target = TARGET_LIGHT;
+		app->sel.id = 0;
+	}
+	if (key == MLX_KEY_C || key == MLX_KEY_L)
+		return (true);
+	camera_build_frame(&app->scene.camera, app->width, app->height, &fr);
+	s = move_step(app);
+	if (key == MLX_KEY_W || key == MLX_KEY_S)
+		apply_move(app, v3_mul(fr.forward, s * sign(key, MLX_KEY_S)));
+	else if (key == MLX_KEY_D || key == MLX_KEY_A)
+		apply_move(app, v3_mul(fr.right, s * sign(key, MLX_KEY_A)));
+	else if (key == MLX_KEY_E || key == MLX_KEY_Q)
+		apply_move(app, v3_mul(fr.up, s * sign(key, MLX_KEY_Q)));
+	else if (key == MLX_KEY_LEFT || key == MLX_KEY_RIGHT)
+		apply_turn(app, fr.up, TURN_DEG * sign(key, MLX_KEY_RIGHT));
+	else if (key == MLX_KEY_UP || key == MLX_KEY_DOWN)
+		apply_turn(app, fr.right, TURN_DEG * sign(key, MLX_KEY_DOWN));
+	else
+		return (false);
+	return (true);
+}
+/*
+* Purpose: Movement keys, applied to the current target (C: camera,
+* L: first light, then the next one on each further press, left click:
+* object under the cursor).
+* Logic: W/S, A/D and Q/E move along the view's forward, right and up
+* axes; arrows turn around the view's up (left/right) and right (up/down)
+* axes, so controls follow what is on screen whatever the target.
+*/
+
+void	app_on_mouse(mouse_key_t button, action_t action, modifier_key_t mods,
+		void *param)
+{
+	t_app		*app;
+	t_cam_frame	fr;
+	int32_t		x;
+	int32_t		y;
+	int			i;
+
+	(void)mods;
+	app = (t_app *)param;
+	if (button != MLX_MOUSE_BUTTON_LEFT || action != MLX_PRESS)
+		return ;
+	mlx_get_mouse_pos(app->mlx, &x, &y);
+	camera_build_frame(&app->scene.camera, app->width, app->height, &fr);
+	app->sel.id = scene_pick(&app->scene, camera_ray(&fr,
+				((float)x + 0.5f) / (float)app->width,
+				1.0f - ((float)y + 0.5f) / (float)app->height));
+	app->sel.target = TARGET_CAMERA;
+	if (app->sel.id < 0)
+		return ;
+	app->sel.obj = app->scene.objects;
+	i = 0;
+	while (i++ < app->sel.id && app->sel.obj)
+		app->sel.obj = app->sel.obj->next;
+	if (app->sel.obj)
+		app->sel.target = TARGET_OBJECT;
+}
+/*
+* Purpose: Left click selects the object under the cursor for the movement
+* keys and the wheel; clicking the background gives control back to the
+* camera.
+*/
+
+void	app_on_scroll(double xdelta, double ydelta, void *param)
+{
+	t_app		*app;
+	t_camera	*cam;
+	float		f;
+
+	(void)xdelta;
+	app = (t_app *)param;
+	if (ydelta == 0.0)
+		return ;
+	f = SCALE_STEP;
+	if (ydelta < 0.0)
+		f = 1.0f / SCALE_STEP;
+	if (app->sel.target == TARGET_CAMERA)
+	{
+		cam = &app->scene.camera;
+		cam->fov_deg = clampf(cam->fov_deg / f, 1.0f, 179.0f);
+	}
+	else if (app->sel.target == TARGET_LIGHT
+		|| !object_scale(app->sel.obj, f))
+		return ;
+	edited(app);
+}
+/*
+* Purpose: Wheel resizes the selected object, or zooms the camera (narrower
+* field of view when scrolling up).
+*/
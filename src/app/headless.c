@@ -0,0 +1,21 @@
+#include "../../include/minirt.h"
+#include "../../include/app.h"
+#include "../../include/render.h"
+#include "../../include/image_write.h"
+
+int	app_render_to_file(t_app *app, const char *path)
+{
+	render_scene(app);
+	if (image_write(path, app->framebuffer, app->width, app->height) < 0)
+	{
+		ft_putstr_fd((char *)"Error\ncannot write image: ", 2);
+		ft_putstr_fd((char *)path, 2);
+		ft_putstr_fd((char *)"\n", 2);
+		return (-1);
+	}
+	return (0);
+}
+/*
+* Purpose: Headless --output mode: trace the frame into the framebuffer and
+* save it, without MLX/GLFW ever being initialised.
+*/
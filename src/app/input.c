@@ -4,33 +4,113 @@
 #include "../../include/render.h"
 #include "../../include/ui.h"
 
+static void	present(t_app *app)
+{
+	t_cam_frame	fr;
+
+	render_reshade(app);
+	upload_framebuffer(app->image, app->framebuffer);
+	if (app->overlay.visible)
+	{
+		camera_build_frame(&app->scene.camera, app->width,
+			app->height, &fr);
+		ti_show_axes(&app->overlay, &fr);
+	}
+}
+/*
+* Purpose: Redraw after a change that only affects shading (display mode,
+* light colour/brightness, ambient): no ray is traced when a G-buffer is
+* available.
+*/
+
+static float	step_clamped(float value, float step)
+{
+	value += step;
+	if (value < 0.0f)
+		return (0.0f);
+	if (value > 1.0f)
+		return (1.0f);
+	return (value);
+}
+
+static int	step_lights(t_app *app, float step)
+{
+	t_light	*l;
+	int		i;
+
+	if (app->sel.target == TARGET_LIGHT)
+	{
+		l = &app->scene.lights[app->sel.id];
+		l->bright = step_clamped(l->bright, step);
+	}
+	i = -1;
+	while (app->sel.target != TARGET_LIGHT && ++i < app->scene.light_count)
+		app->scene.lights[i].bright = step_clamped(app->scene.lights[i].bright,
+				step);
+	if (app->scene.light_count > SHADOW_BUDGET)
+		return (2);
+	return (1);
+}
+/*
+* Purpose: Change the brightness of the selected light, or of every light
+* when no light is selected.
+* Returns: 2 when the scene has more lights than SHADOW_BUDGET: which
+* lights a pixel samples depends on their brightness, so the image has to
+* be traced again rather than re-shaded.
+*/
+
+static int	shading_key(t_app *app, keys_t key)
+{
+	if (key == MLX_KEY_EQUAL)
+		return (step_lights(app, 0.1f));
+	else if (key == MLX_KEY_MINUS)
+		return (step_lights(app, -0.1f));
+	else if (key == MLX_KEY_RIGHT_BRACKET)
+		app->scene.ambient.ratio = step_clamped(app->scene.ambient.ratio, 0.1f);
+	else if (key == MLX_KEY_LEFT_BRACKET)
+		app->scene.ambient.ratio = step_clamped(app->scene.ambient.ratio,
+				-0.1f);
+	else
+		return (0);
+	return (1);
+}
+/*
+* Purpose: +/- change the light brightness and ]/[ the ambient ratio, both
+* kept in the [0, 1] range the parser accepts.
+* Returns: 0 for other keys, else what the change needs (see step_lights).
+*/
+
 void	app_on_key(mlx_key_data_t keydata, void *param)
 {
 	t_app		*app;
 	t_cam_frame	fr;
+	int			shading;
+
 	app = (t_app *)param;
 	if (keydata.key == MLX_KEY_ESCAPE && keydata.action == MLX_PRESS)
 		mlx_close_window(app->mlx);
+	if (keydata.action == MLX_RELEASE)
+		return ;
 	if (keydata.key == MLX_KEY_N && keydata.action == MLX_PRESS)
 	{
 		app->show_normals = !app->show_normals;
-		render_scene(app);
-		upload_framebuffer(app->image, app->framebuffer);
-		if (app->overlay.visible)
-		{
-			camera_build_frame(&app->scene.camera, app->image->width,
-				app->image->height, &fr);
-			ti_show_axes(&app->overlay, &fr);
-		}
+		present(app);
 	}
+	shading = shading_key(app, keydata.key);
+	if (shading == 2)
+		render_moved(app);
+	else if (shading)
+		present(app);
+	else if (controls_key(app, keydata.key))
+		return ;
 	if (keydata.key == MLX_KEY_I && keydata.action == MLX_PRESS)
 	{
 		if (app->overlay.visible)
 			ti_hide(&app->overlay);
 		else
 		{	
-			camera_build_frame(&app->scene.camera, app->image->width,
-				app->image->height, &fr);
+			camera_build_frame(&app->scene.camera, app->width,
+				app->height, &fr);
 			ti_show_axes(&app->overlay, &fr);
 		}
 	}
@@ -0,0 +1,59 @@
+#include "../../include/minirt.h"
+#include "../../include/controls.h"
+#include "../../include/hit.h"
+
+bool	object_translate(t_object *obj, t_vec3 d)
+{
+	if (obj->type == OBJ_SPHERE)
+		obj->u_obj.sp.center = v3_add(obj->u_obj.sp.center, d);
+	else if (obj->type == OBJ_PLANE)
+		obj->u_obj.pl.point = v3_add(obj->u_obj.pl.point, d);
+	else if (obj->type == OBJ_CYLINDER)
+	{
+		obj->u_obj.cy.center = v3_add(obj->u_obj.cy.center, d);
+		cylinder_prepare(&obj->u_obj.cy);
+	}
+	else
+		return (false);
+	return (true);
+}
+
+bool	object_rotate(t_object *obj, t_vec3 axis, float angle)
+{
+	if (obj->type == OBJ_PLANE)
+		obj->u_obj.pl.normal = v3_norm(v3_rotate(obj->u_obj.pl.normal,
+					axis, angle));
+	else if (obj->type == OBJ_CYLINDER)
+	{
+		obj->u_obj.cy.axis = v3_rotate(obj->u_obj.cy.axis, axis, angle);
+		cylinder_prepare(&obj->u_obj.cy);
+	}
+	else
+		return (false);
+	return (true);
+}
+/*
+* Purpose: Turn the orientation of `obj` around the unit vector `axis`;
+* spheres have none. The result is renormalised so repeated turns do not
+* drift away from unit length.
+*/
+
+bool	object_scale(t_object *obj, float factor)
+{
+	if (obj->type == OBJ_SPHERE)
+		obj->u_obj.sp.di *= factor;
+	else if (obj->type == OBJ_CYLINDER)
+	{
+		obj->u_obj.cy.di *= factor;
+		obj->u_obj.cy.he *= factor;
+		cylinder_prepare(&obj->u_obj.cy);
+	}
+	else
+		return (false);
+	return (true);
+}
+/*
+* Purpose: Resize `obj` uniformly around its centre; planes are infinite.
+* Notes: Every cylinder edit ends in cylinder_prepare, which refreshes the
+* cap centres and radius the ray test reads.
+*/
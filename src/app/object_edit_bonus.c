@@ -0,0 +1,130 @@
+#include "../../include/minirt.h"
+#include "../../include/controls.h"
+#include "../../include/hit_bonus.h"
+#include "../../include/mesh_bonus.h"
+
+static void	triangle_map(t_triangle *tr, t_vec3 axis, float angle,
+		float factor)
+{
+	t_vec3	g;
+
+	g = v3_div(v3_add(v3_add(tr->a, tr->b), tr->c), 3.0f);
+	tr->a = v3_add(g, v3_mul(v3_rotate(v3_sub(tr->a, g), axis, angle),
+				factor));
+	tr->b = v3_add(g, v3_mul(v3_rotate(v3_sub(tr->b, g), axis, angle),
+				factor));
+	tr->c = v3_add(g, v3_mul(v3_rotate(v3_sub(tr->c, g), axis, angle),
+				factor));
+	triangle_prepare(tr);
+}
+/*
+* Purpose: Rotate and scale the vertices around the centroid, then refresh
+* the edges, normal and barycentric setup derived from them.
+*/
+
+bool	object_translate(t_object *obj, t_vec3 d)
+{
+	t_triangle	*tr;
+
+	if (obj->type == OBJ_SPHERE)
+		obj->u_obj.sp.center = v3_add(obj->u_obj.sp.center, d);
+	else if (obj->type == OBJ_PLANE)
+		obj->u_obj.pl.point = v3_add(obj->u_obj.pl.point, d);
+	else if (obj->type == OBJ_CYLINDER)
+	{
+		obj->u_obj.cy.center = v3_add(obj->u_obj.cy.center, d);
+		cylinder_prepare(&obj->u_obj.cy);
+	}
+	else if (obj->type == OBJ_HPARABOLOID)
+		obj->u_obj.hp.center = v3_add(obj->u_obj.hp.center, d);
+	else if (obj->type == OBJ_TRIANGLE)
+	{
+		tr = &obj->u_obj.tr;
+		tr->a = v3_add(tr->a, d);
+		tr->b = v3_add(tr->b, d);
+		tr->c = v3_add(tr->c, d);
+	}
+	else if (obj->type == OBJ_MESH)
+		mesh_transform(obj->u_obj.me.data, v3(0.0f, 0.0f, 0.0f), 1.0f, d);
+	else
+		return (false);
+	return (true);
+}
+/*
+* Notes: Moving a triangle keeps its edges and normal, so triangle_prepare
+* is not needed here; a cylinder's cap centres do move with it.
+*/
+
+bool	object_rotate(t_object *obj, t_vec3 axis, float angle)
+{
+	t_plane		*pl;
+	t_hparab	*hp;
+
+	if (obj->type == OBJ_PLANE)
+	{
+		pl = &obj->u_obj.pl;
+		pl->normal = v3_norm(v3_rotate(pl->normal, axis, angle));
+		pl->u = v3_norm(v3_rotate(pl->u, axis, angle));
+		pl->v = v3_cross(pl->normal, pl->u);
+	}
+	else if (obj->type == OBJ_CYLINDER)
+	{
+		obj->u_obj.cy.axis = v3_rotate(obj->u_obj.cy.axis, axis, angle);
+		cylinder_prepare(&obj->u_obj.cy);
+	}
+	else if (obj->type == OBJ_HPARABOLOID)
+	{
+		hp = &obj->u_obj.hp;
+		hp->axis = v3_norm(v3_rotate(hp->axis, axis, angle));
+		hp->u = v3_norm(v3_rotate(hp->u, axis, angle));
+		hp->v = v3_norm(v3_cross(hp->axis, hp->u));
+	}
+	else if (obj->type == OBJ_TRIANGLE)
+		triangle_map(&obj->u_obj.tr, axis, angle, 1.0f);
+	else
+		return (false);
+	return (true);
+}
+/*
+* Purpose: Turn `obj` around the unit vector `axis`. Checker/texture axes
+* (u, v) turn with the surface so the pattern stays attached to it.
+* Notes: Spheres have no orientation; meshes are only moved and resized
+* (turning one would need its normals and BVH rebuilt).
+*/
+
+bool	object_scale(t_object *obj, float factor)
+{
+	t_aabb	box;
+
+	if (obj->type == OBJ_SPHERE)
+		obj->u_obj.sp.di *= factor;
+	else if (obj->type == OBJ_CYLINDER)
+	{
+		obj->u_obj.cy.di *= factor;
+		obj->u_obj.cy.he *= factor;
+		cylinder_prepare(&obj->u_obj.cy);
+	}
+	else if (obj->type == OBJ_HPARABOLOID)
+	{
+		obj->u_obj.hp.rx *= factor;
+		obj->u_obj.hp.ry *= factor;
+		obj->u_obj.hp.height *= factor;
+		hparab_prepare(&obj->u_obj.hp);
+	}
+	else if (obj->type == OBJ_TRIANGLE)
+		triangle_map(&obj->u_obj.tr, v3(0.0f, 1.0f, 0.0f), 0.0f, factor);
+	else if (obj->type == OBJ_MESH && obj->u_obj.me.data->bvh.node_count > 0)
+	{
+		box = obj->u_obj.me.data->bvh.nodes[0].box;
+		mesh_transform(obj->u_obj.me.data,
+			v3_mul(v3_add(box.min, box.max), 0.5f), factor,
+			v3(0.0f, 0.0f, 0.0f));
+	}
+	else
+		return (false);
+	return (true);
+}
+/*
+* Purpose: Resize `obj` uniformly around its centre (a mesh around the
+* centre of its bounding box); planes are infinite.
+*/
@@ -0,0 +1,206 @@
+#include <time.h>
+#include "../../include/minirt.h"
+#include "../../include/scene_bonus.h"
+#include "../../include/parser_bonus.h"
+#include "../../include/render.h"
+#include "../../include/app.h"
+#include "../../include/accel.h"
+#include "../../include/workers.h"
+#include "../../include/cli.h"
+#include "../../include/ray_stats.h"
+
+/* Min and running sum of one timed phase over all repetitions. */
+typedef struct s_bench_stat
+{
+	double	min;
+	double	sum;
+}	t_bench_stat;
+
+typedef struct s_bench_scene
+{
+	t_bench_stat	parse;
+	t_bench_stat	accel;
+	t_bench_stat	render;
+	int				objects;
+	t_bvh_stats		bvh;
+	uint64_t		shadow_rays;
+	char			*error;
+}	t_bench_scene;
+
+static double	now_ms(void)
+{
+	struct timespec	ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ((double)ts.tv_sec * 1e3 + (double)ts.tv_nsec * 1e-6);
+}
+
+static void	stat_add(t_bench_stat *s, double start, double end, int rep)
+{
+	if (rep == 0 || end - start < s->min)
+		s->min = end - start;
+	s->sum += end - start;
+}
+
+static int	run_once(t_app *app, const char *path, t_bench_scene *b, int rep)
+{
+	t_parse_result		pr;
+	const t_object		*o;
+	double				t[4];
+
+	scene_init(&app->scene);
+	t[0] = now_ms();
+	pr = parse_scene(path, &app->scene);
+	t[1] = now_ms();
+	if (!pr.ok)
+		return (b->error = pr.message, scene_free(&app->scene), -1);
+	if (scene_build_accel(&app->scene) < 0)
+		return (b->error = ft_strdup("failed to build scene BVH"),
+			scene_free(&app->scene), -1);
+	t[2] = now_ms();
+	ray_stats_take_shadow();
+	render_scene(app);
+	t[3] = now_ms();
+	b->shadow_rays = ray_stats_take_shadow();
+	stat_add(&b->parse, t[0], t[1], rep);
+	stat_add(&b->accel, t[1], t[2], rep);
+	stat_add(&b->render, t[2], t[3], rep);
+	bvh_stats(&app->scene.accel->bvh, &b->bvh);
+	b->objects = 0;
+	o = app->scene.objects;
+	while (o && ++b->objects)
+		o = o->next;
+	scene_free(&app->scene);
+	return (0);
+}
+/*
+* Purpose: Parse, build the BVH and render `path` once, timing each phase
+* and measuring the tree.
+*/
+
+static void	put_json_string(const char *s)
+{
+	putchar('"');
+	while (s && *s)
+	{
+		if (*s == '"' || *s == '\\')
+			printf("\\%c", *s);
+		else if ((unsigned char)*s < 0x20)
+			printf("\\u%04x", (unsigned char)*s);
+		else
+			putchar(*s);
+		s++;
+	}
+	putchar('"');
+}
+
+static void	put_scene(const t_app *app, const char *path,
+		const t_bench_scene *b, int reps)
+{
+	uint64_t	primary;
+	double		mean;
+
+	printf("    {\"scene\": ");
+	put_json_string(path);
+	if (b->error)
+	{
+		printf(", \"ok\": false, \"error\": ");
+		put_json_string(b->error);
+		printf("}");
+		return ;
+	}
+	primary = (uint64_t)app->width * (uint64_t)app->height;
+	mean = b->render.sum / reps;
+	printf(", \"ok\": true, \"objects\": %d,\n", b->objects);
+	printf("     \"parse_ms\": {\"min\": %.3f, \"mean\": %.3f},\n",
+		b->parse.min, b->parse.sum / reps);
+	printf("     \"accel_ms\": {\"min\": %.3f, \"mean\": %.3f},\n",
+		b->accel.min, b->accel.sum / reps);
+	printf("     \"bvh\": {\"nodes\": %d, \"leaves\": %d, \"depth\": %d, "
+		"\"sah_cost\": %.2f},\n", b->bvh.nodes, b->bvh.leaves, b->bvh.depth,
+		b->bvh.sah_cost);
+	printf("     \"render_ms\": {\"min\": %.3f, \"mean\": %.3f},\n",
+		b->render.min, mean);
+	printf("     \"primary_rays\": %llu, \"shadow_rays\": %llu, "
+		"\"rays_per_sec\": %.0f}", (unsigned long long)primary,
+		(unsigned long long)b->shadow_rays,
+		(double)(primary + b->shadow_rays) / (mean * 1e-3));
+}
+
+static void	bench_scene(t_app *app, const char *path, int reps, int first)
+{
+	t_bench_scene	b;
+	int				rep;
+
+	ft_bzero(&b, sizeof(b));
+	rep = 0;
+	while (rep < reps && run_once(app, path, &b, rep) == 0)
+		rep++;
+	if (!first)
+		printf(",\n");
+	put_scene(app, path, &b, reps);
+	free(b.error);
+	fflush(stdout);
+}
+
+static int	parse_args(int ac, char **av, t_app *app, int *reps)
+{
+	int	i;
+
+	*reps = 3;
+	app->width = WIN_W;
+	app->height = WIN_H;
+	i = 1;
+	while (i + 1 < ac && av[i][0] == '-')
+	{
+		if (ft_strcmp(av[i], "-n") == 0 && ft_isnumstr(av[i + 1]))
+			*reps = ft_atoi(av[i + 1]);
+		else if (ft_strcmp(av[i], "--size") != 0
+			|| cli_parse_size(av[i + 1], &app->width, &app->height) < 0)
+			return (-1);
+		i += 2;
+	}
+	if (*reps < 1 || i >= ac)
+		return (-1);
+	return (i);
+}
+
+int	main(int ac, char **av)
+{
+	t_app	app;
+	int		reps;
+	int		i;
+	int		first;
+
+	ft_bzero(&app, sizeof(app));
+	i = parse_args(ac, av, &app, &reps);
+	if (i < 0)
+		return (ft_putstr_fd((char *)"Usage: miniRT_bench [-n reps] "
+				"[--size WxH] <scene.rt>...\n", 2), 1);
+	app.threads = workers_default_count();
+	app.framebuffer = (uint32_t *)malloc(sizeof(uint32_t)
+			* (size_t)app.width * (size_t)app.height);
+	if (!app.framebuffer)
+		return (ft_putstr_fd((char *)"Error\nfailed to allocate "
+				"framebuffer\n", 2), 1);
+	printf("{\n  \"width\": %d, \"height\": %d, \"threads\": %d, "
+		"\"repetitions\": %d,\n  \"scenes\": [\n",
+		app.width, app.height, app.threads, reps);
+	first = 1;
+	while (i < ac)
+	{
+		bench_scene(&app, av[i++], reps, first);
+		first = 0;
+	}
+	printf("\n  ]\n}\n");
+	free(app.framebuffer);
+	return (0);
+}
+/*
+* Purpose: Headless benchmark: for every scene, time parsing, BVH build and
+* rendering over `reps` runs and print the results as one JSON document.
+* Notes: Built from the bonus sources (which parse every example scene)
+* with -DMINIRT_STATS so shadow rays are counted; see `make bench`.
+* The BVH cache is off unless MINIRT_BVH_CACHE names a directory, so
+* accel_ms times real builds.
+*/
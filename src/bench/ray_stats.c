@@ -0,0 +1,16 @@
+#include <stdatomic.h>
+#include "../../include/ray_stats.h"
+
+_Thread_local uint64_t	g_stat_shadow_rays = 0;
+static atomic_uint_fast64_t	g_shadow_total = 0;
+
+void	ray_stats_flush_thread(void)
+{
+	atomic_fetch_add(&g_shadow_total, g_stat_shadow_rays);
+	g_stat_shadow_rays = 0;
+}
+
+uint64_t	ray_stats_take_shadow(void)
+{
+	return ((uint64_t)atomic_exchange(&g_shadow_total, 0));
+}
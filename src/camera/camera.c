@@ -27,3 +27,12 @@ void	camera_build_frame(const t_camera *cam, int width, int height,
 	out->lower_left = v3_sub(v3_sub(center, v3_mul(out->horizontal, 0.5f)),
 			v3_mul(out->vertical, 0.5f));
 }
+
+t_ray	camera_ray(const t_cam_frame *fr, float u, float v)
+{
+	t_vec3	sample;
+
+	sample = v3_add(fr->lower_left, v3_add(v3_mul(fr->horizontal, u),
+				v3_mul(fr->vertical, v)));
+	return (ray(fr->origin, v3_norm(v3_sub(sample, fr->origin))));
+}
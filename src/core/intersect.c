@@ -1,6 +1,18 @@
+#include <float.h>
 #include "../../include/minirt.h"
 #include "../../include/scene.h"
 #include "../../include/hit.h"
+#include "../../include/accel.h"
+
+/*
+* Closest-hit search state: only the winner's distance (in the BVH query)
+* and cylinder part are tracked; the hit record is built afterwards.
+*/
+typedef struct s_hit_ctx
+{
+	const t_accel	*accel;
+	int				part;
+}	t_hit_ctx;
 
 static void	set_common_hit(t_hit *dst, float t, t_vec3 p, t_vec3 n, t_vec3 albedo)
 {
@@ -54,12 +66,12 @@ static int record_cylinder(const t_cyl *cy, t_ray r, float t, t_hit *out, int hi
 	t_vec3 p;
 	t_vec3 n;
 	p = ray_at(r, t);
-    if (hit_part == 0)
+    if (hit_part == CYL_SIDE)
         n = v3_norm(normal_cyl(cy, p));
-    else if (hit_part == 1)
-        n = v3_norm(cy->axis);
-    else if (hit_part == 2)
-        n = v3_norm(v3_mul(cy->axis, -1));
+    else if (hit_part == CYL_TOP)
+        n = cy->axis;
+    else if (hit_part == CYL_BOTTOM)
+        n = v3_mul(cy->axis, -1);
     else
     {
 		return 0;
@@ -69,48 +81,202 @@ static int record_cylinder(const t_cyl *cy, t_ray r, float t, t_hit *out, int hi
 	return (1);
 }
 
-static int	object_hit(const t_object *obj, t_ray r, t_hit *out)
+static float	object_t(const t_object *obj, t_ray r, int *part)
 {
-	float	t;
-	int		hit_part;
-
-	t = -1.0f;
-	hit_part = -1.0f;
+	*part = -1;
 	if (obj->type == OBJ_SPHERE)
-		t = hit_sphere(&obj->u_obj.sp, r);
-	else if (obj->type == OBJ_PLANE)
-		t = hit_plane(&obj->u_obj.pl, r);
-	else if (obj->type == OBJ_CYLINDER)
-		t = hit_cylinder(&obj->u_obj.cy, r, &hit_part);
-	if (t <= 0.0f)
-		return (0);
+		return (hit_sphere(&obj->u_obj.sp, r));
+	if (obj->type == OBJ_PLANE)
+		return (hit_plane(&obj->u_obj.pl, r));
+	if (obj->type == OBJ_CYLINDER)
+		return (hit_cylinder(&obj->u_obj.cy, r, part));
+	return (-1.0f);
+}
+/*
+* Purpose: Distance to `obj` along `r` (<= 0 on miss), without a hit record.
+* Notes: For cylinders `part` tells side or cap (t_cyl_part).
+*/
+
+static int	record_object(const t_object *obj, t_ray r, float t, int part,
+		t_hit *out)
+{
 	if (obj->type == OBJ_SPHERE)
 		return (record_sphere(&obj->u_obj.sp, r, t, out));
 	if (obj->type == OBJ_PLANE)
 		return (record_plane(&obj->u_obj.pl, r, t, out));
-	return (record_cylinder(&obj->u_obj.cy, r, t, out, hit_part)); // cambiar por record_cylinder cuando esté lista
+	return (record_cylinder(&obj->u_obj.cy, r, t, out, part));
 }
 
-int	scene_hit(const t_scene *scene, t_ray r, float max_dist, t_hit *out)
+static const t_object	*closest_linear(const t_scene *scene, t_ray r,
+		float *best, int *part)
 {
 	const t_object	*o;
-	float			best;
-	t_hit			cur;
-	int				found;
+	const t_object	*win;
+	float			t;
+	int				p;
 
-	out->ok = 0;
-	found = 0;
-	best = max_dist;
+	win = NULL;
 	o = scene->objects;
 	while (o)
 	{
-		if (object_hit(o, r, &cur) && cur.t > EPSILON && cur.t < best)
+		t = object_t(o, r, &p);
+		if (t > EPSILON && t < *best)
 		{
-			best = cur.t;
-			*out = cur;
-			found = 1;
+			*best = t;
+			*part = p;
+			win = o;
 		}
 		o = o->next;
 	}
-	return (found);
+	return (win);
+}
+/*
+* Purpose: Plain scan used when the scene has no BVH.
+*/
+
+static int	object_leaf(int id, t_bvh_ray *q, void *ctx)
+{
+	t_hit_ctx	*c;
+	float		t;
+	int			part;
+
+	c = (t_hit_ctx *)ctx;
+	part = -1;
+	if (!packed_t(&c->accel->packed, id, q->r, &t))
+		t = object_t(c->accel->objects[id], q->r, &part);
+	if (t <= EPSILON || !bvh_ray_accept(q, t, id))
+		return (0);
+	c->part = part;
+	return (1);
+}
+/*
+* Purpose: BVH/plane leaf: test object `id` from its packed hot data when it
+* has some, falling back to the full t_object otherwise.
+*/
+
+int	scene_hit(const t_scene *scene, t_ray r, float max_dist, t_hit *out)
+{
+	const t_object	*win;
+	t_hit_ctx		c;
+	t_bvh_ray		q;
+
+	out->ok = 0;
+	c.part = -1;
+	win = NULL;
+	if (scene->accel)
+	{
+		c.accel = scene->accel;
+		bvh_ray_init(&q, r, max_dist, 0);
+		accel_traverse(scene->accel, &q, object_leaf, &c);
+		if (q.found)
+			win = scene->accel->objects[q.best];
+		max_dist = q.tmax;
+	}
+	else
+		win = closest_linear(scene, r, &max_dist, &c.part);
+	if (!win)
+		return (0);
+	return (record_object(win, r, max_dist, c.part, out));
+}
+/*
+* Purpose: Closest hit along `r` within (EPSILON, max_dist).
+* Logic: The search only compares distances (ties go to the earlier list
+* entry); normal and colour are computed once, for the winner.
+*/
+
+int	scene_occluded(const t_scene *scene, t_ray r, float max_dist)
+{
+	const t_object	*o;
+	t_hit_ctx		c;
+	t_bvh_ray		q;
+	float			t;
+
+	if (scene->accel)
+	{
+		c.accel = scene->accel;
+		bvh_ray_init(&q, r, max_dist, 1);
+		accel_traverse(scene->accel, &q, object_leaf, &c);
+		return (q.found);
+	}
+	o = scene->objects;
+	while (o)
+	{
+		t = object_t(o, r, &c.part);
+		if (t > EPSILON && t < max_dist)
+			return (1);
+		o = o->next;
+	}
+	return (0);
+}
+/*
+* Purpose: Tell whether anything blocks `r` within (EPSILON, max_dist).
+* Logic: Any-hit query: only the distance of each candidate is computed
+* (no point, normal, texture or specular) and the walk stops at the first
+* blocker instead of looking for the closest one.
+*/
+
+int	scene_pick(const t_scene *scene, t_ray r)
+{
+	t_hit_ctx	c;
+	t_bvh_ray	q;
+
+	if (!scene->accel)
+		return (-1);
+	c.accel = scene->accel;
+	c.part = -1;
+	bvh_ray_init(&q, r, INFINITY, 0);
+	accel_traverse(scene->accel, &q, object_leaf, &c);
+	return (q.best);
+}
+/*
+* Purpose: Object under a screen ray, for selecting what the interactive
+* controls move. Same search as scene_hit, without building a hit record.
+*/
+
+static void	object_packet(int id, t_packet *pk, int mask, void *ctx)
+{
+	(void)ctx;
+	packet_scalar(pk, mask, object_leaf, id);
+}
+/*
+* Purpose: Objects without packed data (cylinders) are tested one lane at
+* a time with the scalar leaf.
+*/
+
+void	scene_hit_packet(const t_scene *scene, const t_ray *rays, int count,
+		t_hit *out)
+{
+	t_packet	pk;
+	t_hit_ctx	c[PACKET_W];
+	int			i;
+
+	i = -1;
+	if (!scene->accel || count < 2)
+	{
+		while (++i < count)
+			scene_hit(scene, rays[i], FLT_MAX, &out[i]);
+		return ;
+	}
+	packet_init(&pk, rays, count, FLT_MAX);
+	while (++i < count)
+	{
+		c[i].accel = scene->accel;
+		c[i].part = -1;
+		pk.ctx[i] = &c[i];
+	}
+	accel_traverse_packet(scene->accel, &pk, object_packet);
+	i = -1;
+	while (++i < count)
+	{
+		out[i].ok = 0;
+		if (pk.q[i].found)
+			record_object(scene->accel->objects[pk.q[i].best], rays[i],
+				pk.q[i].tmax, c[i].part, &out[i]);
+	}
 }
+/*
+* Purpose: Closest hits of a run of neighbouring primary rays.
+* Logic: One packet walk finds every lane's winner (id, distance and part),
+* then the hit records are built per lane exactly as scene_hit does. A
+* lone ray is not worth a packet and goes through scene_hit.
+*/
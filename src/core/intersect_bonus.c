@@ -1,37 +1,21 @@
+#include <float.h>
 #include "../../include/minirt.h"
 #include "../../include/scene_bonus.h"
 #include "../../include/hit_bonus.h"
 #include "../../include/bump_bonus.h"
+#include "../../include/accel.h"
+#include "../../include/mesh_bonus.h"
 
-//Ispecular​=ks​⋅Ilight​⋅max(0,N⋅H)α
-t_vec3 specular_blinn_phong(const t_scene *scene, const t_hit *hit, t_material *material)
+// Guarda ks y shininess del material; el brillo especular depende de la
+// posicion de cada luz y se calcula al sombrear (ver gbuffer.h).
+static void	set_specular(t_hit *hit, const t_material *material)
 {
-
+	hit->ks = 0.0f;
+	hit->shininess = 0.0f;
 	if (!material || !hit->ok)
-		return v3(0.0f, 0.0f, 0.0f);
-	//t_vec3 p = hit->p;
-	t_vec3 n = v3_norm(hit->n); //
-	t_vec3 l = v3_norm(v3_sub(scene->light.pos, hit->p)); //direccion hacia la luz
-	t_vec3 v = v3_norm(v3_sub(scene->camera.pos, hit->p)); // direccion hacia la camara
-	t_vec3 h = v3_norm(v3_add(l, v));
-	//t_vec3 albedo =  material.albedo;
-	float ks = material->ks;
-	float shininess = material->shininess;
-
-
-	//ks * (scene->light.pos * (n*h))shinniness;
-	//v3_dot(n, h); mide cuanto el vector halfway se alinea con la normal, cuanto mayor es mas fuerte es el reflejo
-	//n⋅h=cos(θ)
-	//donde θ es el ángulo entre la normal y el vector halfway
-	t_vec3 light_intensity = v3_mul(scene->light.color, scene->light.bright);
-	float spec_angle = v3_dot(n, h);
-	if(spec_angle < 0.0f)
-		spec_angle = 0.0f;
-	float spec_intensity = powf(spec_angle, shininess);
-	//printf("ks: %f, shininess: %f\n", ks, shininess);
-	//printf("spec_angle: %f, spec_intensity: %f\n", spec_angle, spec_intensity);
-	t_vec3 spec_color = v3_mul(v3_mul(light_intensity, spec_intensity), ks);
-	return (spec_color);
+		return ;
+	hit->ks = material->ks;
+	hit->shininess = material->shininess;
 }
 
 static void	set_common_hit(t_hit *dst, float t, t_vec3 p, t_vec3 n, t_vec3 albedo)
@@ -49,7 +33,7 @@ static void	orient_normal(t_hit *hit, t_ray r)
 		hit->n = v3_mul(hit->n, -1.0f);
 }
 
-static int	record_sphere(const t_scene *scene, const t_sphere *sp, t_ray r, float t, t_hit *out)
+static int	record_sphere(const t_sphere *sp, t_ray r, float t, t_hit *out)
 {
 	t_vec3	p;
 	t_vec3	n;
@@ -93,15 +77,12 @@ static int	record_sphere(const t_scene *scene, const t_sphere *sp, t_ray r, floa
 		bump_perturb(sp->bump, u, v, tan, bit, sp->bump_strength, &out->n);
 	}
 	//!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
-	if(sp->material)
-		out->specular = specular_blinn_phong(scene, out, sp->material);
-	else
-		out->specular = v3(0.0f, 0.0f, 0.0f);
+	set_specular(out, sp->material);
 	orient_normal(out, r);
 	return (1);
 }
 
-static int	record_plane(const t_scene *scene, const t_plane *pl, t_ray r, float t, t_hit *out)
+static int	record_plane(const t_plane *pl, t_ray r, float t, t_hit *out)
 {
 	t_vec3	p;
 	t_vec3	rel;
@@ -134,28 +115,21 @@ static int	record_plane(const t_scene *scene, const t_plane *pl, t_ray r, float
 		bump_perturb(pl->bump, u, v, pl->u, pl->v, pl->bump_strength, &out->n);
 	}
 	//!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
-	if(pl->material)
-		out->specular = specular_blinn_phong(scene, out, pl->material);
-	else
-		out->specular = v3(0.0f, 0.0f, 0.0f);
+	set_specular(out, pl->material);
 	orient_normal(out, r);
 	return (1);
 }
 
-static int	record_triangle(const t_scene *scene, const t_triangle *tr, t_ray r, float t, t_hit *out)
+static int	record_triangle(const t_triangle *tr, t_ray r, float t, t_hit *out)
 {
     t_vec3	p;
-    t_vec3	e1;
-    t_vec3	e2;
     t_vec3	n;
     int		par;
     float	u;
     float	v;
 
     p = ray_at(r, t);
-    e1 = v3_sub(tr->b, tr->a);
-    e2 = v3_sub(tr->c, tr->a);
-    n = v3_norm(v3_cross(e1, e2));
+    n = tr->n;
     if (tr->has_checker)
     {
         par = (int)floorf(v3_dot(v3_sub(p, tr->a), tr->u) / tr->checker_scale)
@@ -168,32 +142,20 @@ static int	record_triangle(const t_scene *scene, const t_triangle *tr, t_ray r,
     else
         set_common_hit(out, t, p, n, tr->color);
     // Bump: usar baricéntricas para estirar el mapa a todo el triángulo
-    if (tr->has_bump && tr->bump)
+    if (tr->has_bump && tr->bump && tr->inv_denom != 0.0f)
     {
         t_vec3 pa = v3_sub(p, tr->a);
-        float d00 = v3_dot(e1, e1);
-        float d01 = v3_dot(e1, e2);
-        float d11 = v3_dot(e2, e2);
-        float d20 = v3_dot(pa, e1);
-        float d21 = v3_dot(pa, e2);
-        float denom = d00 * d11 - d01 * d01;
-        if (fabsf(denom) > 1e-12f)
-        {
-            float vb = (d11 * d20 - d01 * d21) / denom;
-            float wb = (d00 * d21 - d01 * d20) / denom;
-            u = vb;        // (u,v) de textura = (vb, wb)
-            v = wb;
-            // Base tangente a partir de e1,e2
-            t_vec3 tan = v3_norm(e1);
-            t_vec3 bit = v3_norm(v3_cross(n, tan));
-            bump_perturb(tr->bump, u, v, tan, bit, tr->bump_strength, &out->n);
-        }
+        float d20 = v3_dot(pa, tr->e1);
+        float d21 = v3_dot(pa, tr->e2);
+        // (u,v) de textura = baricéntricas (vb, wb)
+        u = (tr->d11 * d20 - tr->d01 * d21) * tr->inv_denom;
+        v = (tr->d00 * d21 - tr->d01 * d20) * tr->inv_denom;
+        // Base tangente a partir de e1 (tr->u == norm(e1))
+        t_vec3 bit = v3_norm(v3_cross(n, tr->u));
+        bump_perturb(tr->bump, u, v, tr->u, bit, tr->bump_strength, &out->n);
     }
 		//!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
-	if(tr->material)
-		out->specular = specular_blinn_phong(scene, out, tr->material);
-	else
-		out->specular = v3(0.0f, 0.0f, 0.0f);
+	set_specular(out, tr->material);
     orient_normal(out, r);
     return (1);
 }
@@ -209,7 +171,7 @@ static t_vec3	hp_checker_color(const t_hparab *hp, float x, float y)
 	return (hp->color);
 }
 
-static int	record_hparaboloid(const t_scene *scene, const t_hparab *hp, t_ray r, float t, t_hit *out)
+static int	record_hparaboloid(const t_hparab *hp, t_ray r, float t, t_hit *out)
 {
     t_vec3	p;
     float	x;
@@ -238,66 +200,345 @@ static int	record_hparaboloid(const t_scene *scene, const t_hparab *hp, t_ray r,
         bump_perturb(hp->bump, u, v, hp->u, hp->v, hp->bump_strength, &out->n);
     }
 			//!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
-	if(hp->material)
-		out->specular = specular_blinn_phong(scene, out, hp->material);
-	else
-		out->specular = v3(0.0f, 0.0f, 0.0f);
+	set_specular(out, hp->material);
     orient_normal(out, r);
     return (1);
 }
 
-// static int record_cylinder(const t_cyl *cy, t_ray r, float t, t_hit *out)
-// {
-	
-// }
+static int	record_mesh(const t_mesh *me, int tri, t_ray r, float t,
+		t_hit *out)
+{
+	set_common_hit(out, t, ray_at(r, t), mesh_tri_normal(me->data, tri),
+		me->color);
+	set_specular(out, NULL);
+	orient_normal(out, r);
+	return (1);
+}
+
+static void	cyl_side(const t_cyl *cy, t_vec3 p, t_vec3 bu, t_cy_aux *s)
+{
+	t_vec3	rel;
+	float	h;
+	float	ang;
+
+	rel = v3_sub(p, cy->center);
+	h = v3_dot(rel, cy->axis);
+	s->n = v3_norm(v3_sub(rel, v3_mul(cy->axis, h)));
+	ang = atan2f(v3_dot(s->n, v3_cross(cy->axis, bu)), v3_dot(s->n, bu));
+	if (ang < 0.0f)
+		ang += 6.283185307179586f; // 2*pi
+	s->tan = v3_cross(cy->axis, s->n);
+	s->bit = cy->axis;
+	s->u = ang * (cy->di * 0.5f); // arco en unidades de mundo, como la esfera
+	s->v = h;
+	s->tu = ang / 6.283185307179586f;
+	s->tv = h / cy->he + 0.5f;
+}
+
+static void	cyl_surface(const t_cyl *cy, int part, t_vec3 p, t_cy_aux *s)
+{
+	t_vec3	up;
+	t_vec3	bu;
+	t_vec3	rel;
+
+	up = v3(0.0f, 1.0f, 0.0f);
+	if (fabsf(v3_dot(cy->axis, up)) > 0.999f)
+		up = v3(1.0f, 0.0f, 0.0f);
+	bu = v3_norm(v3_cross(up, cy->axis));
+	if (part == CYL_SIDE)
+	{
+		cyl_side(cy, p, bu, s);
+		return ;
+	}
+	s->n = cy->axis;
+	rel = v3_sub(p, cy->top);
+	if (part == CYL_BOTTOM)
+	{
+		s->n = v3_mul(cy->axis, -1.0f);
+		rel = v3_sub(p, cy->bottom);
+	}
+	s->tan = bu;
+	s->bit = v3_cross(s->n, bu);
+	s->u = v3_dot(rel, s->tan);
+	s->v = v3_dot(rel, s->bit);
+	s->tu = s->u / cy->di + 0.5f;
+	s->tv = s->v / cy->di + 0.5f;
+}
+/*
+* Purpose: Normal, tangent basis and surface coordinates of a cylinder hit.
+* Logic: The side is unrolled around the axis (angle measured from a fixed
+* direction bu normal to it, height along it); caps are flat disks mapped
+* like a plane through the cap centre.
+*/
 
-static int	object_hit(const t_scene *scene, const t_object *obj, t_ray r, t_hit *out)
+static int	record_cylinder(const t_cyl *cy, int part, t_ray r, float t,
+		t_hit *out)
 {
-	float	t;
+	t_vec3		p;
+	t_cy_aux	s;
+	int			par;
 
-	t = -1.0f;
+	p = ray_at(r, t);
+	cyl_surface(cy, part, p, &s);
+	par = 0;
+	if (cy->has_checker)
+		par = (int)floorf(s.u / cy->checker_scale)
+			+ (int)floorf(s.v / cy->checker_scale);
+	if (par & 1)
+		set_common_hit(out, t, p, s.n, v3_sub(v3(1.0f, 1.0f, 1.0f),
+				cy->color));
+	else
+		set_common_hit(out, t, p, s.n, cy->color);
+	if (cy->has_bump && cy->bump)
+		bump_perturb(cy->bump, s.tu, s.tv, s.tan, s.bit, cy->bump_strength,
+			&out->n);
+	set_specular(out, cy->material);
+	orient_normal(out, r);
+	return (1);
+}
+/*
+* Purpose: Hit record of the side or cap `part` reported by hit_cylinder,
+* with the same checker, bump and specular handling as the other shapes.
+*/
+
+typedef struct s_hit_ctx
+{
+	const t_accel	*accel;
+	int				prim;
+}	t_hit_ctx;
+
+static float	object_t(const t_object *obj, const t_bvh_ray *q, int *prim)
+{
+	t_ray	r;
+
+	r = q->r;
+	if (obj->type == OBJ_MESH)
+		return (mesh_hit(obj->u_obj.me.data, q, prim));
 	if (obj->type == OBJ_SPHERE)
-		t = hit_sphere(&obj->u_obj.sp, r);
-	else if (obj->type == OBJ_PLANE)
-		t = hit_plane(&obj->u_obj.pl, r);
-	else if (obj->type == OBJ_TRIANGLE)
-		t = hit_triangle(&obj->u_obj.tr, r);
-	else if (obj->type == OBJ_CYLINDER)
-		t = hit_cylinder(&obj->u_obj.cy, r);
-	else if (obj->type == OBJ_HPARABOLOID)
-		t = hit_hparaboloid(&obj->u_obj.hp, r);
-	if (t <= 0.0f)
-		return (0);
+		return (hit_sphere(&obj->u_obj.sp, r));
+	if (obj->type == OBJ_PLANE)
+		return (hit_plane(&obj->u_obj.pl, r));
+	if (obj->type == OBJ_TRIANGLE)
+		return (hit_triangle(&obj->u_obj.tr, r));
+	if (obj->type == OBJ_CYLINDER)
+		return (hit_cylinder(&obj->u_obj.cy, r, prim));
+	if (obj->type == OBJ_HPARABOLOID)
+		return (hit_hparaboloid(&obj->u_obj.hp, r));
+	return (-1.0f);
+}
+/*
+* Purpose: Distance to `obj` along q->r (<= 0 on miss), without a hit record.
+* Notes: A mesh walks its own BVH within q's current bound and reports the
+* triangle it hit through `prim`; a cylinder reports its part there.
+*/
+
+static int	record_object(const t_object *obj, t_hit_ctx *c, t_ray r,
+		float t, t_hit *out)
+{
+	if (obj->type == OBJ_MESH)
+		return (record_mesh(&obj->u_obj.me, c->prim, r, t, out));
 	if (obj->type == OBJ_SPHERE)
-		return (record_sphere(scene, &obj->u_obj.sp, r, t, out));
+		return (record_sphere(&obj->u_obj.sp, r, t, out));
 	if (obj->type == OBJ_PLANE)
-		return (record_plane(scene, &obj->u_obj.pl, r, t, out));
+		return (record_plane(&obj->u_obj.pl, r, t, out));
 	if (obj->type == OBJ_HPARABOLOID)
-		return (record_hparaboloid(scene, &obj->u_obj.hp, r, t, out));
-	return (record_triangle(scene, &obj->u_obj.tr, r, t, out));
-	//!!!!!! tengo que añadir el cilindro aqui y añadir a la funcion del cilindro el specular index;
+		return (record_hparaboloid(&obj->u_obj.hp, r, t, out));
+	if (obj->type == OBJ_CYLINDER)
+		return (record_cylinder(&obj->u_obj.cy, c->prim, r, t, out));
+	return (record_triangle(&obj->u_obj.tr, r, t, out));
 }
+/*
+* Purpose: Build the full hit record (checker, bump, specular) for the
+* winning object only.
+*/
 
-int	scene_hit(const t_scene *scene, t_ray r, float max_dist, t_hit *out)
+static const t_object	*closest_linear(const t_scene *scene, t_ray r,
+		float *best, int *prim)
 {
 	const t_object	*o;
-	float			best;
-	t_hit			cur;
-	int				found;
+	const t_object	*win;
+	t_bvh_ray		q;
+	float			t;
+	int				p;
 
-	out->ok = 0;
-	found = 0;
-	best = max_dist;
+	win = NULL;
 	o = scene->objects;
 	while (o)
 	{
-		if (object_hit(scene , o, r, &cur) && cur.t > EPSILON && cur.t < best)
+		bvh_ray_init(&q, r, *best, 0);
+		t = object_t(o, &q, &p);
+		if (t > EPSILON && t < *best)
 		{
-			best = cur.t;
-			*out = cur;
-			found = 1;
+			*best = t;
+			*prim = p;
+			win = o;
 		}
 		o = o->next;
 	}
-	return (found);
+	return (win);
+}
+/*
+* Purpose: Plain scan used when the scene has no BVH.
+*/
+
+static int	object_leaf(int id, t_bvh_ray *q, void *ctx)
+{
+	t_hit_ctx	*c;
+	float		t;
+	int			prim;
+
+	c = (t_hit_ctx *)ctx;
+	prim = -1;
+	if (!packed_t(&c->accel->packed, id, q->r, &t))
+		t = object_t(c->accel->objects[id], q, &prim);
+	if (t <= EPSILON || !bvh_ray_accept(q, t, id))
+		return (0);
+	c->prim = prim;
+	return (1);
+}
+/*
+* Purpose: BVH/plane leaf: test object `id` from its packed hot data when it
+* has some, falling back to the full t_object otherwise.
+*/
+
+int	scene_hit(const t_scene *scene, t_ray r, float max_dist, t_hit *out)
+{
+	const t_object	*win;
+	t_bvh_ray		q;
+	t_hit_ctx		c;
+
+	out->ok = 0;
+	win = NULL;
+	c.accel = scene->accel;
+	c.prim = -1;
+	if (scene->accel)
+	{
+		bvh_ray_init(&q, r, max_dist, 0);
+		accel_traverse(scene->accel, &q, object_leaf, &c);
+		if (q.found)
+			win = scene->accel->objects[q.best];
+		max_dist = q.tmax;
+	}
+	else
+		win = closest_linear(scene, r, &max_dist, &c.prim);
+	if (!win)
+		return (0);
+	return (record_object(win, &c, r, max_dist, out));
+}
+/*
+* Purpose: Closest hit along `r` within (EPSILON, max_dist).
+* Logic: The search only compares distances (ties go to the earlier list
+* entry); checker, bump and specular run once, for the winner.
+*/
+
+int	scene_occluded(const t_scene *scene, t_ray r, float max_dist)
+{
+	const t_object	*o;
+	t_bvh_ray		q;
+	t_hit_ctx		c;
+	float			t;
+
+	c.accel = scene->accel;
+	if (scene->accel)
+	{
+		bvh_ray_init(&q, r, max_dist, 1);
+		accel_traverse(scene->accel, &q, object_leaf, &c);
+		return (q.found);
+	}
+	o = scene->objects;
+	while (o)
+	{
+		bvh_ray_init(&q, r, max_dist, 1);
+		t = object_t(o, &q, &c.prim);
+		if (t > EPSILON && t < max_dist)
+			return (1);
+		o = o->next;
+	}
+	return (0);
+}
+/*
+* Purpose: Tell whether anything blocks `r` within (EPSILON, max_dist).
+* Logic: Any-hit query: only the distance of each candidate is computed
+* (no point, normal, texture or specular) and the walk stops at the first
+* blocker instead of looking for the closest one.
+*/
+
+int	scene_pick(const t_scene *scene, t_ray r)
+{
+	t_hit_ctx	c;
+	t_bvh_ray	q;
+
+	if (!scene->accel)
+		return (-1);
+	c.accel = scene->accel;
+	c.prim = -1;
+	bvh_ray_init(&q, r, INFINITY, 0);
+	accel_traverse(scene->accel, &q, object_leaf, &c);
+	return (q.best);
+}
+/*
+* Purpose: Object under a screen ray, for selecting what the interactive
+* controls move. Same search as scene_hit, without building a hit record.
+*/
+
+static void	object_packet(int id, t_packet *pk, int mask, void *ctx)
+{
+	const t_object	*obj;
+	t_packet		hits;
+	int				i;
+
+	obj = ((const t_accel *)ctx)->objects[id];
+	if (obj->type != OBJ_MESH)
+		return (packet_scalar(pk, mask, object_leaf, id));
+	mask = mesh_hit_packet(obj->u_obj.me.data, pk, mask, &hits);
+	while (mask)
+	{
+		i = __builtin_ctz(mask);
+		mask &= mask - 1;
+		if (hits.q[i].tmax > EPSILON
+			&& packet_accept(pk, i, hits.q[i].tmax, id))
+			((t_hit_ctx *)pk->ctx[i])->prim = hits.q[i].best;
+	}
+}
+/*
+* Purpose: Objects without packed data: a mesh is walked as a packet
+* through its own BVH, the rest (cylinders, paraboloids) lane by lane.
+*/
+
+void	scene_hit_packet(const t_scene *scene, const t_ray *rays, int count,
+		t_hit *out)
+{
+	t_packet	pk;
+	t_hit_ctx	c[PACKET_W];
+	int			i;
+
+	i = -1;
+	if (!scene->accel || count < 2)
+	{
+		while (++i < count)
+			scene_hit(scene, rays[i], FLT_MAX, &out[i]);
+		return ;
+	}
+	packet_init(&pk, rays, count, FLT_MAX);
+	while (++i < count)
+	{
+		c[i].accel = scene->accel;
+		c[i].prim = -1;
+		pk.ctx[i] = &c[i];
+	}
+	accel_traverse_packet(scene->accel, &pk, object_packet);
+	i = -1;
+	while (++i < count)
+	{
+		out[i].ok = 0;
+		if (pk.q[i].found)
+			record_object(scene->accel->objects[pk.q[i].best], &c[i],
+				rays[i], pk.q[i].tmax, &out[i]);
+	}
 }
+/*
+* Purpose: Closest hits of a run of neighbouring primary rays.
+* Logic: One packet walk finds every lane's winner (id, distance and part),
+* then the hit records are built per lane exactly as scene_hit does. A
+* lone ray is not worth a packet and goes through scene_hit.
+*/
@@ -1,6 +1,7 @@
 #include <stdlib.h>
 #include "vec3.h"
 #include "scene.h"
+#include "accel.h"
 
 // Inicializa la escena con valores por defecto y flags de presencia en falso.
 // Esto permite validar que A, C, L se declaren exactamente una vez en el parser.
@@ -14,11 +15,11 @@ void	scene_init(t_scene *s)
 	s->camera.fov_deg = 70.0f;
 	s->camera.focal = 1.0f;
 	s->camera.present = false;
-	s->light.pos = v3(0, 0, 0);
-	s->light.bright = 0.0f;
-	s->light.color = v3(1, 1, 1);
-	s->light.present = false;
+	s->lights = NULL;
+	s->light_count = 0;
+	s->light_cap = 0;
 	s->objects = NULL;
+	s->accel = NULL;
 }
 /*
 * Purpose: Initialize the scene with defaults and presence flags set to false.
@@ -40,10 +41,17 @@ void	scene_free(t_scene *s)
 		it = n;
 	}
 	s->objects = NULL;
+	free(s->lights);
+	s->lights = NULL;
+	s->light_count = 0;
+	s->light_cap = 0;
+	accel_free(s->accel);
+	s->accel = NULL;
 }
 /*
 * Purpose: Free all scene objects and leave the scene in a clean state.
-* Logic: Walk the linked list, free each node, and set objects = NULL.
+* Logic: Walk the linked list, free each node, and set objects = NULL;
+* the acceleration structure indexes those nodes, so it goes too.
 */
 
 void	scene_add_object(t_scene *s, t_object *obj)
@@ -56,3 +64,39 @@ void	scene_add_object(t_scene *s, t_object *obj)
 * Logic: Push-front insertion into the linked list.
 * Notes: Order doesn't affect ray tracing; all intersections are tested.
 */
+
+const char	*scene_add_light(t_scene *s, const t_light *l)
+{
+	if (s->light_count > 0)
+		return ("Duplicated L");
+	s->lights = (t_light *)malloc(sizeof(t_light));
+	if (!s->lights)
+		return ("L: not enough memory");
+	s->lights[0] = *l;
+	s->light_count = 1;
+	s->light_cap = 1;
+	return (NULL);
+}
+/*
+* Purpose: Record the single light of a mandatory scene.
+* Checks: A second L is rejected, as the subject requires.
+*/
+
+void	scene_adopt(t_scene *s, t_scene *from)
+{
+	t_object	*tail;
+
+	if (!from->objects)
+		return ;
+	tail = from->objects;
+	while (tail->next)
+		tail = tail->next;
+	tail->next = s->objects;
+	s->objects = from->objects;
+	from->objects = NULL;
+}
+/*
+* Purpose: Splice a scene parsed apart (one chunk of the file) into `s`.
+* Notes: Objects are pushed front as they are read, so adopting chunks in
+* file order rebuilds the list a single pass would have produced.
+*/
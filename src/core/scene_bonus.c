@@ -1,7 +1,11 @@
 #include <stdlib.h>
+#include <sys/mman.h>
+#include "../../libraries/libft/libft.h"
 #include "vec3.h"
 #include "scene_bonus.h"
 #include "bump_bonus.h"
+#include "accel.h"
+#include "mesh_bonus.h"
 
 // Inicializa la escena con valores por defecto y flags de presencia en falso.
 // Esto permite validar que A, C, L se declaren exactamente una vez en el parser.
@@ -15,11 +19,14 @@ void	scene_init(t_scene *s)
 	s->camera.fov_deg = 70.0f;
 	s->camera.focal = 1.0f;
 	s->camera.present = false;
-	s->light.pos = v3(0, 0, 0);
-	s->light.bright = 0.0f;
-	s->light.color = v3(1, 1, 1);
-	s->light.present = false;
+	s->lights = NULL;
+	s->light_count = 0;
+	s->light_cap = 0;
 	s->objects = NULL;
+	s->accel = NULL;
+	s->bumps = NULL;
+	s->block = NULL;
+	s->block_size = 0;
 /*---------------------------------------------------------*/
 	/* s->material.albedo = v3(1.0f, 1.0f, 1.0f);
 	s->material.ks = 0.3f;        // Coeficiente especular
@@ -42,23 +49,40 @@ void	scene_free(t_scene *s)
 	{
 		n = it->next;
 		if (it->type == OBJ_SPHERE && it->u_obj.sp.bump)
-			bump_free(it->u_obj.sp.bump);
+			bump_release(&s->bumps, it->u_obj.sp.bump);
 		else if (it->type == OBJ_PLANE && it->u_obj.pl.bump)
-			bump_free(it->u_obj.pl.bump);
+			bump_release(&s->bumps, it->u_obj.pl.bump);
 		else if (it->type == OBJ_CYLINDER && it->u_obj.cy.bump)
-			bump_free(it->u_obj.cy.bump);
+			bump_release(&s->bumps, it->u_obj.cy.bump);
 		else if (it->type == OBJ_TRIANGLE && it->u_obj.tr.bump)
-			bump_free(it->u_obj.tr.bump);
+			bump_release(&s->bumps, it->u_obj.tr.bump);
 		else if (it->type == OBJ_HPARABOLOID && it->u_obj.hp.bump)
-			bump_free(it->u_obj.hp.bump);
-		free(it);
+			bump_release(&s->bumps, it->u_obj.hp.bump);
+		else if (it->type == OBJ_MESH)
+			mesh_free(it->u_obj.me.data);
+		if (!s->block)
+			free(it);
 		it = n;
 	}
 	s->objects = NULL;
+	if (s->block)
+		munmap(s->block, s->block_size);
+	s->block = NULL;
+	s->block_size = 0;
+	free(s->lights);
+	s->lights = NULL;
+	s->light_count = 0;
+	s->light_cap = 0;
+	bump_cache_clear(&s->bumps);
+	accel_free(s->accel);
+	s->accel = NULL;
 }
 /*
 * Purpose: Free all scene objects and leave the scene in a clean state.
-* Logic: Walk the linked list, free each node, and set objects = NULL.
+* Logic: Walk the linked list, free each node, and set objects = NULL;
+* bump maps are handed back to the scene cache, which frees each one with
+* its last user. The acceleration structure indexes those nodes, so it
+* goes too. Objects loaded from a .rtb cache go with their mapping.
 */
 
 void	scene_add_object(t_scene *s, t_object *obj)
@@ -71,3 +95,66 @@ void	scene_add_object(t_scene *s, t_object *obj)
 * Logic: Push-front insertion into the linked list.
 * Notes: Order doesn't affect ray tracing; all intersections are tested.
 */
+
+const char	*scene_add_light(t_scene *s, const t_light *l)
+{
+	t_light	*grown;
+	int		cap;
+
+	if (s->light_count > UINT16_MAX)
+		return ("L: too many lights");
+	if (s->light_count == s->light_cap)
+	{
+		cap = s->light_cap * 2;
+		if (cap == 0)
+			cap = 4;
+		grown = (t_light *)malloc(sizeof(t_light) * (size_t)cap);
+		if (!grown)
+			return ("L: not enough memory");
+		if (s->light_count)
+			ft_memcpy(grown, s->lights, sizeof(t_light)
+				* (size_t)s->light_count);
+		free(s->lights);
+		s->lights = grown;
+		s->light_cap = cap;
+	}
+	s->lights[s->light_count++] = *l;
+	return (NULL);
+}
+/*
+* Purpose: Append a light; the bonus part accepts any number of L lines.
+* Logic: The array doubles when full, so N lights cost O(log N) copies.
+* Notes: Capped at 65536 lights, the range of a G-buffer light slot.
+*/
+
+void	scene_adopt(t_scene *s, t_scene *from)
+{
+	t_object	*tail;
+	t_bumpmap	*last;
+
+	if (from->objects)
+	{
+		tail = from->objects;
+		while (tail->next)
+			tail = tail->next;
+		tail->next = s->objects;
+		s->objects = from->objects;
+		from->objects = NULL;
+	}
+	if (from->bumps)
+	{
+		last = from->bumps;
+		while (last->next)
+			last = last->next;
+		last->next = s->bumps;
+		s->bumps = from->bumps;
+		from->bumps = NULL;
+	}
+}
+/*
+* Purpose: Splice a scene parsed apart (one chunk of the file) into `s`.
+* Notes: Objects are pushed front as they are read, so adopting chunks in
+* file order rebuilds the list a single pass would have produced. Each
+* chunk decoded its own bump maps; a PNG used in several chunks is kept
+* once per chunk, every copy released by its own objects.
+*/
@@ -0,0 +1,60 @@
+#include <pthread.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "../../include/workers.h"
+
+static int	clamp_workers(long n)
+{
+	if (n < 1)
+		return (1);
+	if (n > WORKERS_MAX)
+		return (WORKERS_MAX);
+	return ((int)n);
+}
+
+int	workers_default_count(void)
+{
+	const char	*env;
+	long		n;
+
+	env = getenv("MINIRT_THREADS");
+	if (env && *env)
+	{
+		n = 0;
+		while (*env >= '0' && *env <= '9' && n <= WORKERS_MAX)
+			n = n * 10 + (*env++ - '0');
+		if (*env == '\0' && n > 0)
+			return (clamp_workers(n));
+	}
+	return (clamp_workers(sysconf(_SC_NPROCESSORS_ONLN)));
+}
+/*
+* Purpose: Pick how many render threads to spawn.
+* Logic: An explicit MINIRT_THREADS=<n> wins; malformed values are ignored
+* and the online CPU count is used instead.
+*/
+
+void	workers_run(int count, t_worker_fn fn, void *ctx)
+{
+	pthread_t	threads[WORKERS_MAX];
+	int			spawned;
+	int			i;
+
+	count = clamp_workers(count);
+	spawned = 0;
+	while (spawned < count - 1)
+	{
+		if (pthread_create(&threads[spawned], NULL, fn, ctx) != 0)
+			break ;
+		spawned++;
+	}
+	fn(ctx);
+	i = 0;
+	while (i < spawned)
+		pthread_join(threads[i++], NULL);
+}
+/*
+* Purpose: Fan `fn` out over `count` threads and join them.
+* Notes: The calling thread is one of the workers, so count == 1 never
+* touches pthreads at all.
+*/
@@ -0,0 +1,164 @@
+#include <stdlib.h>
+#include "../../libraries/libft/libft.h"
+#include "../../include/batch.h"
+#ifndef SCENE_HEADER
+# define SCENE_HEADER "scene.h"
+#endif
+#include SCENE_HEADER
+
+const t_batch_ops	*batch_ops(void)
+{
+	static const t_batch_ops	base = {"base", batch_spheres_base,
+		batch_tris_base, batch_cylinders_base};
+#ifdef BATCH_X86
+	static const t_batch_ops	avx2 = {"avx2", batch_spheres_avx2,
+		batch_tris_avx2, batch_cylinders_avx2};
+
+	if (__builtin_cpu_supports("avx2"))
+		return (&avx2);
+#endif
+	return (&base);
+}
+/*
+* Purpose: Runtime dispatch: the AVX2 kernels when the CPU has AVX2, the
+* baseline build otherwise (SSE on x86-64, generic code elsewhere).
+* Notes: Both variants perform the same float operations, so the choice
+* never changes a pixel.
+*/
+
+static float	*soa_block(int count, int fields)
+{
+	return ((float *)ft_calloc((size_t)(count + BATCH_W) * (size_t)fields,
+		sizeof(float)));
+}
+
+int	sphere_soa_init(t_sphere_soa *s, int count)
+{
+	int	n;
+
+	n = count + BATCH_W;
+	s->count = count;
+	s->cx = soa_block(count, 4);
+	if (!s->cx)
+		return (-1);
+	s->cy = s->cx + n;
+	s->cz = s->cy + n;
+	s->r2 = s->cz + n;
+	return (0);
+}
+/*
+* Purpose: One zeroed allocation split into the per-field arrays; the
+* padding entries are harmless (their lanes are never read back).
+*/
+
+void	sphere_soa_set(t_sphere_soa *s, int i, const t_sphere_hot *sp)
+{
+	s->cx[i] = sp->center.x;
+	s->cy[i] = sp->center.y;
+	s->cz[i] = sp->center.z;
+	s->r2[i] = sp->r2;
+}
+
+void	sphere_soa_free(t_sphere_soa *s)
+{
+	free(s->cx);
+	ft_bzero(s, sizeof(*s));
+}
+
+int	tri_soa_init(t_tri_soa *s, int count)
+{
+	int	n;
+
+	n = count + BATCH_W;
+	s->count = count;
+	s->ax = soa_block(count, 9);
+	if (!s->ax)
+		return (-1);
+	s->ay = s->ax + n;
+	s->az = s->ay + n;
+	s->e1x = s->az + n;
+	s->e1y = s->e1x + n;
+	s->e1z = s->e1y + n;
+	s->e2x = s->e1z + n;
+	s->e2y = s->e2x + n;
+	s->e2z = s->e2y + n;
+	return (0);
+}
+
+void	tri_soa_set(t_tri_soa *s, int i, const t_tri_hot *tr)
+{
+	s->ax[i] = tr->a.x;
+	s->ay[i] = tr->a.y;
+	s->az[i] = tr->a.z;
+	s->e1x[i] = tr->e1.x;
+	s->e1y[i] = tr->e1.y;
+	s->e1z[i] = tr->e1.z;
+	s->e2x[i] = tr->e2.x;
+	s->e2y[i] = tr->e2.y;
+	s->e2z[i] = tr->e2.z;
+}
+
+t_tri_hot	tri_soa_get(const t_tri_soa *s, int i)
+{
+	t_tri_hot	tr;
+
+	tr.a = v3(s->ax[i], s->ay[i], s->az[i]);
+	tr.e1 = v3(s->e1x[i], s->e1y[i], s->e1z[i]);
+	tr.e2 = v3(s->e2x[i], s->e2y[i], s->e2z[i]);
+	return (tr);
+}
+
+void	tri_soa_free(t_tri_soa *s)
+{
+	free(s->ax);
+	ft_bzero(s, sizeof(*s));
+}
+
+int	cyl_soa_init(t_cyl_soa *s, int count)
+{
+	int	n;
+
+	n = count + BATCH_W;
+	s->count = count;
+	s->cx = soa_block(count, 14);
+	if (!s->cx)
+		return (-1);
+	s->cy = s->cx + n;
+	s->cz = s->cy + n;
+	s->ax = s->cz + n;
+	s->ay = s->ax + n;
+	s->az = s->ay + n;
+	s->tx = s->az + n;
+	s->ty = s->tx + n;
+	s->tz = s->ty + n;
+	s->bx = s->tz + n;
+	s->by = s->bx + n;
+	s->bz = s->by + n;
+	s->r2 = s->bz + n;
+	s->half_he = s->r2 + n;
+	return (0);
+}
+
+void	cyl_soa_set(t_cyl_soa *s, int i, const t_cyl *cy)
+{
+	s->cx[i] = cy->center.x;
+	s->cy[i] = cy->center.y;
+	s->cz[i] = cy->center.z;
+	s->ax[i] = cy->axis.x;
+	s->ay[i] = cy->axis.y;
+	s->az[i] = cy->axis.z;
+	s->tx[i] = cy->top.x;
+	s->ty[i] = cy->top.y;
+	s->tz[i] = cy->top.z;
+	s->bx[i] = cy->bottom.x;
+	s->by[i] = cy->bottom.y;
+	s->bz[i] = cy->bottom.z;
+	s->r2[i] = cy->r2;
+	s->half_he[i] = cy->half_he;
+}
+
+void	cyl_soa_free(t_cyl_soa *s)
+{
+	free(s->cx);
+	ft_bzero(s, sizeof(*s));
+}
@@ -0,0 +1,265 @@
+#include <math.h>
+#include "../../include/batch.h"
+
+#define BATCH_INLINE	static inline __attribute__((always_inline))
+
+BATCH_INLINE t_f8	load(const float *p)
+{
+	t_f8	v;
+
+	__builtin_memcpy(&v, p, sizeof(v));
+	return (v);
+}
+
+BATCH_INLINE void	store(t_f8 t, t_i8 miss, float *out)
+{
+	t = f8_select(miss, (t_f8){0} - 1.0f, t);
+	__builtin_memcpy(out, &t, sizeof(t));
+}
+/*
+* Purpose: Unaligned loads/stores between the SoA arrays and vectors; a
+* missed lane is written as -1 like the scalar tests return.
+*/
+
+BATCH_INLINE void	spheres_body(const t_sphere_soa *s, int first, t_ray r,
+		float *out)
+{
+	t_f8	oc[3];
+	t_f8	half_b;
+	t_f8	disc;
+	t_f8	root;
+	float	a;
+	int		i;
+
+	oc[0] = r.orig.x - load(s->cx + first);
+	oc[1] = r.orig.y - load(s->cy + first);
+	oc[2] = r.orig.z - load(s->cz + first);
+	a = r.dir.x * r.dir.x + r.dir.y * r.dir.y + r.dir.z * r.dir.z;
+	half_b = oc[0] * r.dir.x + oc[1] * r.dir.y + oc[2] * r.dir.z;
+	disc = half_b * half_b - a * ((oc[0] * oc[0] + oc[1] * oc[1]
+				+ oc[2] * oc[2]) - load(s->r2 + first));
+	root = disc;
+	i = -1;
+	while (++i < BATCH_W)
+		root[i] = sqrtf(disc[i]);
+	oc[0] = (-half_b - root) / a;
+	oc[1] = (-half_b + root) / a;
+	store(f8_select(oc[0] > 0.0f, oc[0], oc[1]),
+		(disc < 0.0f) | (~(oc[0] > 0.0f) & ~(oc[1] > 0.0f)), out);
+}
+/*
+* Purpose: sphere_hot_t against BATCH_W spheres: nearest root in front of
+* the origin.
+*/
+
+BATCH_INLINE void	tris_body(const t_tri_soa *s, int first, t_ray r,
+		float *out)
+{
+	t_f8	p[3];
+	t_f8	q[3];
+	t_f8	inv_det;
+	t_f8	u;
+	t_i8	miss;
+
+	p[0] = r.dir.y * load(s->e2z + first) - r.dir.z * load(s->e2y + first);
+	p[1] = r.dir.z * load(s->e2x + first) - r.dir.x * load(s->e2z + first);
+	p[2] = r.dir.x * load(s->e2y + first) - r.dir.y * load(s->e2x + first);
+	inv_det = load(s->e1x + first) * p[0] + load(s->e1y + first) * p[1]
+		+ load(s->e1z + first) * p[2];
+	miss = (inv_det < 1e-8f) & (inv_det > -1e-8f);
+	inv_det = 1.0f / inv_det;
+	q[0] = r.orig.x - load(s->ax + first);
+	q[1] = r.orig.y - load(s->ay + first);
+	q[2] = r.orig.z - load(s->az + first);
+	u = (q[0] * p[0] + q[1] * p[1] + q[2] * p[2]) * inv_det;
+	miss |= (u < 0.0f) | (u > 1.0f);
+	p[0] = q[1] * load(s->e1z + first) - q[2] * load(s->e1y + first);
+	p[1] = q[2] * load(s->e1x + first) - q[0] * load(s->e1z + first);
+	p[2] = q[0] * load(s->e1y + first) - q[1] * load(s->e1x + first);
+	q[0] = (r.dir.x * p[0] + r.dir.y * p[1] + r.dir.z * p[2]) * inv_det;
+	miss |= (q[0] < 0.0f) | ((u + q[0]) > 1.0f);
+	q[0] = (load(s->e2x + first) * p[0] + load(s->e2y + first) * p[1]
+			+ load(s->e2z + first) * p[2]) * inv_det;
+	store(q[0], miss | ~(q[0] > 0.0f), out);
+}
+/*
+* Purpose: tri_hot_t (Moller-Trumbore) against BATCH_W triangles.
+* Logic: As in packet_tri, every lane runs the whole test and the early
+* exits become one miss mask; pvec and qvec share p[], tvec, v and t
+* share q[].
+*/
+
+BATCH_INLINE t_f8	along(const t_cyl_soa *s, int first, const t_f8 *v)
+{
+	return (v[0] * load(s->ax + first) + v[1] * load(s->ay + first)
+		+ v[2] * load(s->az + first));
+}
+/*
+* Purpose: v . axis for BATCH_W cylinders, in v3_dot's order.
+*/
+
+BATCH_INLINE t_f8	cyl_cap(const t_cyl_soa *s, int first, t_ray r,
+		const float *const *c)
+{
+	t_f8	denom;
+	t_f8	t;
+	t_f8	p[3];
+	t_i8	ok;
+
+	denom = r.dir.x * load(s->ax + first) + r.dir.y * load(s->ay + first)
+		+ r.dir.z * load(s->az + first);
+	p[0] = load(c[0] + first) - r.orig.x;
+	p[1] = load(c[1] + first) - r.orig.y;
+	p[2] = load(c[2] + first) - r.orig.z;
+	t = along(s, first, p) / denom;
+	ok = ~((denom < 1e-6f) & (denom > -1e-6f)) & ~(t < 0.0f);
+	p[0] = (r.orig.x + r.dir.x * t) - load(c[0] + first);
+	p[1] = (r.orig.y + r.dir.y * t) - load(c[1] + first);
+	p[2] = (r.orig.z + r.dir.z * t) - load(c[2] + first);
+	ok &= (p[0] * p[0] + p[1] * p[1] + p[2] * p[2]) <= load(s->r2 + first);
+	return (f8_select(ok, t, (t_f8){0} - 1.0f));
+}
+/*
+* Purpose: hit_cap against the cap disks c (top or bottom centres).
+*/
+
+BATCH_INLINE t_i8	cyl_within(const t_cyl_soa *s, int first, t_ray r,
+		t_f8 t)
+{
+	t_f8	p[3];
+	t_f8	h;
+
+	p[0] = (r.orig.x + r.dir.x * t) - load(s->cx + first);
+	p[1] = (r.orig.y + r.dir.y * t) - load(s->cy + first);
+	p[2] = (r.orig.z + r.dir.z * t) - load(s->cz + first);
+	h = along(s, first, p);
+	return (~(t <= 0.0f) & (h <= load(s->half_he + first))
+		& (-h <= load(s->half_he + first)));
+}
+/*
+* Purpose: inside_cyl_height: t in front of the origin and its point no
+* further than half_he from the centre along the axis (|h| <= half_he
+* written as two comparisons, which treat NaN the same way).
+*/
+
+BATCH_INLINE void	cyl_quadratic(const t_cyl_soa *s, int first, t_ray r,
+		t_f8 *q)
+{
+	t_f8	x[3];
+	t_f8	d[3];
+	t_f8	k;
+
+	x[0] = r.orig.x - load(s->cx + first);
+	x[1] = r.orig.y - load(s->cy + first);
+	x[2] = r.orig.z - load(s->cz + first);
+	k = r.dir.x * load(s->ax + first) + r.dir.y * load(s->ay + first)
+		+ r.dir.z * load(s->az + first);
+	d[0] = r.dir.x - load(s->ax + first) * k;
+	d[1] = r.dir.y - load(s->ay + first) * k;
+	d[2] = r.dir.z - load(s->az + first) * k;
+	k = along(s, first, x);
+	x[0] = x[0] - load(s->ax + first) * k;
+	x[1] = x[1] - load(s->ay + first) * k;
+	x[2] = x[2] - load(s->az + first) * k;
+	q[0] = d[0] * d[0] + d[1] * d[1] + d[2] * d[2];
+	q[1] = 2.0f * (d[0] * x[0] + d[1] * x[1] + d[2] * x[2]);
+	q[2] = q[1] * q[1] - (4.0f * q[0] * ((x[0] * x[0] + x[1] * x[1]
+					+ x[2] * x[2]) - load(s->r2 + first)));
+}
+/*
+* Purpose: a, b and the discriminant of hit_side's quadratic into q[0..2],
+* with ray and offset projected off the axis.
+*/
+
+BATCH_INLINE t_f8	cyl_side(const t_cyl_soa *s, int first, t_ray r)
+{
+	t_f8	q[3];
+	t_f8	t[2];
+	t_i8	in[2];
+	double	root;
+	int		i;
+
+	cyl_quadratic(s, first, r, q);
+	i = -1;
+	while (++i < BATCH_W)
+	{
+		root = sqrt((double)q[2][i]);
+		t[0][i] = (float)(((double)(-q[1][i]) - root)
+				/ (double)(2.0f * q[0][i]));
+		t[1][i] = (float)(((double)(-q[1][i]) + root)
+				/ (double)(2.0f * q[0][i]));
+	}
+	in[0] = cyl_within(s, first, r, t[0]);
+	in[1] = cyl_within(s, first, r, t[1]);
+	return (f8_select((q[0] == 0.0f) | (q[2] < 0.0f) | ~(in[0] | in[1]),
+			(t_f8){0} - 1.0f, f8_select(in[0], t[0], t[1])));
+}
+/*
+* Purpose: hit_side: the near root when it lies between the caps, else the
+* far one, else -1.
+* Notes: The roots are taken in double per lane, as hit_side's sqrt()
+* promotes them, so both give the same floats.
+*/
+
+BATCH_INLINE t_f8	closer(t_f8 best, t_f8 t)
+{
+	return (f8_select((t > 0.0f) & (t < best), t, best));
+}
+
+BATCH_INLINE void	cylinders_body(const t_cyl_soa *s, int first, t_ray r,
+		float *out)
+{
+	t_f8	best;
+
+	best = closer((t_f8){0} + 1e30f, cyl_side(s, first, r));
+	best = closer(best, cyl_cap(s, first, r,
+				(const float *[3]){s->tx, s->ty, s->tz}));
+	best = closer(best, cyl_cap(s, first, r,
+				(const float *[3]){s->bx, s->by, s->bz}));
+	store(best, best == 1e30f, out);
+}
+/*
+* Purpose: hit_cylinder against BATCH_W cylinders: the closest of side,
+* top and bottom kept in the same order, -1 when none is in front.
+*/
+
+void	batch_spheres_base(const t_sphere_soa *s, int first, t_ray r, float *t)
+{
+	spheres_body(s, first, r, t);
+}
+
+void	batch_tris_base(const t_tri_soa *s, int first, t_ray r, float *t)
+{
+	tris_body(s, first, r, t);
+}
+
+void	batch_cylinders_base(const t_cyl_soa *s, int first, t_ray r, float *t)
+{
+	cylinders_body(s, first, r, t);
+}
+
+#ifdef BATCH_X86
+
+__attribute__((target("avx2")))
+void	batch_spheres_avx2(const t_sphere_soa *s, int first, t_ray r, float *t)
+{
+	spheres_body(s, first, r, t);
+}
+
+__attribute__((target("avx2")))
+void	batch_tris_avx2(const t_tri_soa *s, int first, t_ray r, float *t)
+{
+	tris_body(s, first, r, t);
+}
+
+__attribute__((target("avx2")))
+void	batch_cylinders_avx2(const t_cyl_soa *s, int first, t_ray r, float *t)
+{
+	cylinders_body(s, first, r, t);
+}
+#endif
+/*
+* Purpose: The same bodies compiled for the build's baseline target and,
+* through the target attribute, for AVX2 (one 8-float register per field
+* instead of two SSE halves). No FMA is enabled, so results match.
+*/
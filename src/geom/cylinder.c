@@ -1,148 +1,110 @@
 #include "../../include/minirt.h"
 #include "../../include/hit.h"
 
-
-static int inside_cyl_height(const t_cyl *cylinder, t_vec3 p, t_vec3 v)
+void	cylinder_prepare(t_cyl *cy)
 {
-	float height_pos = v3_dot(v3_sub(p, cylinder->center), v);
-	if ((fabsf(height_pos) <= cylinder->he * 0.5f))
-		return 1;
-	return 0;
+	cy->axis = v3_norm(cy->axis);
+	cy->half_he = cy->he * 0.5f;
+	cy->r2 = (cy->di * 0.5f) * (cy->di * 0.5f);
+	cy->top = v3_add(cy->center, v3_mul(cy->axis, cy->half_he));
+	cy->bottom = v3_sub(cy->center, v3_mul(cy->axis, cy->half_he));
 }
+/*
+* Purpose: Fill what every ray test needs from the cylinder's shape: unit
+* axis, half height, squared radius and cap centres.
+* Use: After parsing and after any edit of center, axis, di or he.
+*/
 
-static float hit_top_cap(const t_cyl *cylinder, t_ray r, t_vec3 v)
+static float	hit_cap(const t_cyl *cylinder, t_ray r, t_vec3 c)
 {
-	float t;
-	//float denom = v3_dot(r.dir, v);
-	t_vec3 p;
-	t_vec3 c_top;
-	float radio;
-	t_vec3 radial;
+	float	denom;
+	float	t;
+	t_vec3	radial;
 
-	if (fabsf(v3_dot(r.dir, v)) < 1e-6f)
-    	return (-1.0f); //paralelo no hay interseccion
-	c_top = v3_add(cylinder->center, v3_mul(v ,(cylinder->he * 0.5f)));
-	t = v3_dot(v3_sub(c_top, r.orig), v) / v3_dot(r.dir, v);
-	p = v3_add(r.orig, v3_mul(r.dir, t));
-	radio = cylinder->di * 0.5f;
-	radial = v3_sub(p, c_top);
-	if(t < 0.0f)
+	denom = v3_dot(r.dir, cylinder->axis);
+	if (fabsf(denom) < 1e-6f)
+		return (-1.0f); //paralelo no hay interseccion
+	t = v3_dot(v3_sub(c, r.orig), cylinder->axis) / denom;
+	if (t < 0.0f)
 		return (-1.0f);
-	if(v3_dot(radial, radial) <= radio * radio)
-		return t;
+	radial = v3_sub(v3_add(r.orig, v3_mul(r.dir, t)), c);
+	if (v3_dot(radial, radial) <= cylinder->r2)
+		return (t);
 	return (-1.0f);
 }
+/*
+* Purpose: Distance to the cap disk centred on `c` (top or bottom), or -1.
+*/
 
-static float hit_botton_cap(const t_cyl *cylinder, t_ray r, t_vec3 v)
+static int	inside_cyl_height(const t_cyl *cylinder, t_ray r, float t)
 {
-	float t;
-	//float denom = v3_dot(r.dir, v);
-	t_vec3 p;
-	t_vec3 c_bottom;
-	float radio;
-	t_vec3 radial;
-	
-	if (fabsf(v3_dot(r.dir, v)) < 1e-6f)
-    	return (-1.0f); //paralelo no hay interseccion
-	c_bottom = v3_sub(cylinder->center, v3_mul(v ,(cylinder->he * 0.5f)));
-	t = v3_dot(v3_sub(c_bottom, r.orig), v) / v3_dot(r.dir, v);
+	t_vec3	p;
+
+	if (t <= 0.0f)
+		return (0);
 	p = v3_add(r.orig, v3_mul(r.dir, t));
-	radio = cylinder->di * 0.5f;
-	radial = v3_sub(p, c_bottom);
-	if(t < 0.0f)
-		return (-1.0f);
-	if(v3_dot(radial, radial) <= radio * radio)
-		return t;
-	return (-1.0f);
+	return (fabsf(v3_dot(v3_sub(p, cylinder->center), cylinder->axis))
+		<= cylinder->half_he);
 }
 
-typedef struct s_quad {
-    float a;
-    float b;
-    float c;
-} t_quad;
-
-static t_quad cyl_quadratic(const t_cyl *cylinder, t_ray r, t_vec3 x, t_vec3 v)
+static float	hit_side(const t_cyl *cylinder, t_ray r)
 {
-	t_quad q;
-
-	ft_memset(&q, 0,sizeof(t_quad));
-	float x_dot_v = v3_dot(x, v);
-	float d_dot_v = v3_dot(r.dir, v);
+	t_vec3	d_perp;
+	t_vec3	x_perp;
+	float	a;
+	float	b;
+	float	disc;
 
-	q.a = v3_dot(v3_sub(r.dir, v3_mul(v, d_dot_v)), v3_sub(r.dir, v3_mul(v, d_dot_v)));
-	q.b = 2.0f * v3_dot(v3_sub(r.dir, v3_mul(v, d_dot_v)), v3_sub(x, v3_mul(v, x_dot_v)));
-	q.c = (v3_dot(v3_sub(x, v3_mul(v, x_dot_v)), v3_sub(x, v3_mul(v, x_dot_v)))) - (cylinder->di*0.5f) * (cylinder->di*0.5f);
-	return q;
+	x_perp = v3_sub(r.orig, cylinder->center);
+	d_perp = v3_sub(r.dir, v3_mul(cylinder->axis,
+				v3_dot(r.dir, cylinder->axis)));
+	x_perp = v3_sub(x_perp, v3_mul(cylinder->axis,
+				v3_dot(x_perp, cylinder->axis)));
+	a = v3_dot(d_perp, d_perp);
+	if (a == 0.0f)
+		return (-1.0f);
+	b = 2.0f * v3_dot(d_perp, x_perp);
+	disc = (b * b) - (4 * a * (v3_dot(x_perp, x_perp) - cylinder->r2));
+	if (disc < 0.0f)
+		return (-1.0f);
+	if (inside_cyl_height(cylinder, r, (-b - sqrt(disc)) / (2.0f * a)))
+		return ((-b - sqrt(disc)) / (2.0f * a));
+	if (inside_cyl_height(cylinder, r, (-b + sqrt(disc)) / (2.0f * a)))
+		return ((-b + sqrt(disc)) / (2.0f * a));
+	return (-1.0f);
 }
+/*
+* Purpose: Nearest hit on the lateral surface within the height, or -1.
+* Logic: Ray and offset are projected onto the plane normal to the axis,
+* where the side is the circle of radius^2 r2; of the two roots the near
+* one wins when it lies between the caps.
+*/
 
-static float pick_valid_t(const t_cyl *cylinder, t_ray r, float t1, float t2)
+static void	keep(float t, int part, float *best_t, int *hit_part)
 {
-	float t = 1e30;
-	t_vec3 v = v3_norm(cylinder->axis);
-
-	if(t1 > 0.0f)
-	{
-		t_vec3 p1 = v3_add(r.orig, v3_mul(r.dir, t1));
-		if (inside_cyl_height(cylinder, p1, v))
-			t = t1;
-	}
-	if(t2 > 0.0f)
+	if (t > 0.0f && t < *best_t)
 	{
-		t_vec3 p2 = v3_add(r.orig, v3_mul(r.dir, t2));
-		if (inside_cyl_height(cylinder, p2, v) && t2 < t)
-			t = t2;
+		*best_t = t;
+		*hit_part = part;
 	}
-	if(t < 1e29f)
-		return(t);
-	return (-1.0f);
-}
-
-static float hit_side(const t_cyl *cylinder, t_ray r, t_vec3 v)
-{
-	t_vec3	x;
-	t_quad	q;
-	float disc;
-	float t1;
-	float t2;
-
-	x = v3_sub(r.orig, cylinder->center);
-	q = cyl_quadratic(cylinder, r, x, v);
-	if (q.a == 0.0f)
-		return -1.0f;
-	disc = (q.b * q.b) - (4 * q.a * q.c);
-	if(disc < 0.0f)
-		return (-1.0f);
-	t1 = (-q.b - sqrt(disc)) / (2.0f*q.a);
-	t2 = (-q.b + sqrt(disc)) / (2.0f*q.a);
-	return(pick_valid_t(cylinder, r, t1, t2));
 }
 
 float	hit_cylinder(const t_cyl *cylinder, t_ray r, int *hit_part)
 {
-	t_vec3 v = v3_norm(cylinder->axis);
-	float best_t = 1e30f;
-	float t_side = hit_side(cylinder, r, v);
+	float	best_t;
 
+	best_t = 1e30f;
 	*hit_part = -1;
-	if(t_side > 0.0f && t_side < best_t)
-	{
-		best_t = t_side;
-		*hit_part = 0;
-	}
-	float t_top = hit_top_cap(cylinder, r, v);
-	if(t_top > 0.0f && t_top < best_t)
-	{
-		best_t = t_top;
-		*hit_part = 1;
-	}
-	float t_bottom = hit_botton_cap(cylinder, r, v);
-	if(t_bottom > 0.0f && t_bottom < best_t)
-	{
-		best_t = t_bottom;
-		*hit_part = 2;
-	}
-	if (best_t >= 1e30f || *hit_part == -1)
-        return -1.0f;
-	return best_t;
+	keep(hit_side(cylinder, r), CYL_SIDE, &best_t, hit_part);
+	keep(hit_cap(cylinder, r, cylinder->top), CYL_TOP, &best_t, hit_part);
+	keep(hit_cap(cylinder, r, cylinder->bottom), CYL_BOTTOM, &best_t,
+		hit_part);
+	if (*hit_part == -1)
+		return (-1.0f);
+	return (best_t);
 }
+/*
+* Purpose: Distance to the closest of side and caps, or -1 on miss.
+* Notes: `hit_part` tells which one was hit (CYL_SIDE, CYL_TOP or
+* CYL_BOTTOM), for the normal of the hit record.
+*/
@@ -101,3 +101,24 @@ float	hit_hparaboloid(const t_hparab *hp, t_ray r)
 	return (hp_best_candidate(hp, &aux));
 }
 
+void	hparab_prepare(t_hparab *hp)
+{
+	t_vec3	up;
+
+	up = v3(0.0f, 1.0f, 0.0f);
+	if (fabsf(v3_dot(hp->axis, up)) > 0.999f)
+		up = v3(1.0f, 0.0f, 0.0f);
+	hp->u = v3_norm(v3_cross(up, hp->axis));
+	hp->v = v3_norm(v3_cross(hp->axis, hp->u));
+	hp->half_height = hp->height;
+	hp->inv_rx2 = 1.0f / (hp->rx * hp->rx);
+	hp->inv_ry2 = 1.0f / (hp->ry * hp->ry);
+	hp->inv_height = 1.0f / hp->height;
+}
+/*
+* Purpose: Derive the local frame (u, v around axis) and the reciprocal
+* sizes hit_hparaboloid reads from axis, rx, ry and height.
+* Notes: The full height is used as the half-height clamp, which keeps the
+* intended "Pringles" extent along the axis instead of clipping it.
+* Use: Call whenever those fields change (parse time, resizes).
+*/
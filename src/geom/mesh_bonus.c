@@ -0,0 +1,148 @@
+#include "../../include/minirt.h"
+#include "../../include/mesh_bonus.h"
+
+static int	tri_span(int first, int count, t_bvh_ray *q, void *ctx)
+{
+	const t_mesh_data	*m;
+	float				t[BATCH_W];
+	int					hit;
+	int					i;
+
+	m = (const t_mesh_data *)ctx;
+	hit = 0;
+	while (count > 0)
+	{
+		m->batch(&m->soa, first, q->r, t);
+		i = -1;
+		while (++i < count && i < BATCH_W)
+		{
+			if (t[i] > EPSILON
+				&& bvh_ray_accept(q, t[i], m->bvh.index[first + i]))
+			{
+				if (q->any)
+					return (1);
+				hit = 1;
+			}
+		}
+		first += BATCH_W;
+		count -= BATCH_W;
+	}
+	return (hit);
+}
+/*
+* Purpose: Test a whole leaf of the mesh BVH with the batch kernel, then
+* let each triangle that was hit compete as the scalar leaf would.
+*/
+
+float	mesh_hit(const t_mesh_data *mesh, const t_bvh_ray *q, int *tri)
+{
+	t_bvh_ray	mq;
+
+	mq = *q;
+	mq.best = -1;
+	mq.found = 0;
+	bvh_traverse_spans(&mesh->bvh, &mq, tri_span, (void *)mesh);
+	*tri = mq.best;
+	if (!mq.found)
+		return (-1.0f);
+	return (mq.tmax);
+}
+/*
+* Purpose: Intersect the mesh through its own BVH, bounded by the caller's
+* current best distance so hidden parts of the mesh are never visited.
+*/
+
+static int	tri_slot(const t_mesh_data *mesh, int id)
+{
+	int	i;
+
+	i = mesh->bvh.nodes[mesh->bvh.leaf_of[id]].first;
+	while (mesh->bvh.index[i] != id)
+		i++;
+	return (i);
+}
+/*
+* Purpose: Where triangle `id` sits in the leaf-ordered soa: a scan of the
+* one leaf that holds it.
+*/
+
+static void	tri_packet(int id, t_packet *pk, int mask, void *ctx)
+{
+	const t_mesh_data	*m;
+	t_tri_hot			tr;
+	float				t[PACKET_W];
+
+	m = (const t_mesh_data *)ctx;
+	tr = tri_soa_get(&m->soa, tri_slot(m, id));
+	packet_tri(&tr, pk, t);
+	packet_offer(pk, mask, t, id);
+}
+
+int	mesh_hit_packet(const t_mesh_data *mesh, const t_packet *pk, int mask,
+		t_packet *hits)
+{
+	int	found;
+	int	i;
+
+	*hits = *pk;
+	i = -1;
+	while (++i < PACKET_W)
+	{
+		hits->q[i].best = -1;
+		hits->q[i].found = 0;
+	}
+	packet_traverse(&mesh->bvh, hits, mask, tri_packet, (void *)mesh);
+	found = 0;
+	i = -1;
+	while (++i < PACKET_W)
+		if (hits->q[i].found)
+			found |= 1 << i;
+	return (found & mask);
+}
+/*
+* Purpose: mesh_hit for several rays: one packet walk of the mesh BVH,
+* bounded per lane by the caller's current best distances.
+*/
+
+t_vec3	mesh_tri_normal(const t_mesh_data *mesh, int tri)
+{
+	return (mesh->normals[tri]);
+}
+
+static t_vec3	scale_about(t_vec3 p, t_vec3 pivot, float scale, t_vec3 offset)
+{
+	return (v3_add(v3_add(pivot, v3_mul(v3_sub(p, pivot), scale)), offset));
+}
+
+void	mesh_transform(t_mesh_data *mesh, t_vec3 pivot, float scale,
+		t_vec3 offset)
+{
+	t_tri_hot	tr;
+	int			i;
+
+	i = -1;
+	while (++i < mesh->tri_count)
+	{
+		tr = tri_soa_get(&mesh->soa, i);
+		tr.a = scale_about(tr.a, pivot, scale, offset);
+		tr.e1 = v3_mul(tr.e1, scale);
+		tr.e2 = v3_mul(tr.e2, scale);
+		tri_soa_set(&mesh->soa, i, &tr);
+	}
+	i = -1;
+	while (++i < mesh->bvh.node_count)
+	{
+		mesh->bvh.nodes[i].box.min = scale_about(mesh->bvh.nodes[i].box.min,
+				pivot, scale, offset);
+		mesh->bvh.nodes[i].box.max = scale_about(mesh->bvh.nodes[i].box.max,
+				pivot, scale, offset);
+		bvh_wide_refit(&mesh->bvh, i);
+	}
+}
+/*
+* Purpose: Move and/or uniformly resize the whole mesh in place:
+* p' = pivot + (p - pivot) * scale + offset.
+* Notes: With scale > 0 this map sends every box to the box of the mapped
+* triangles, so the mesh BVH stays valid without a rebuild; normals do not
+* change. The boxes were padded when built, which absorbs the rounding.
+*/
@@ -6,8 +6,8 @@ float	hit_triangle(const t_triangle *tr, t_ray r)
 	t_tr_aux	vars;
 	float		t;
 
-	vars.e1 = v3_sub(tr->b, tr->a);
-	vars.e2 = v3_sub(tr->c, tr->a);
+	vars.e1 = tr->e1;
+	vars.e2 = tr->e2;
 	vars.pvec = v3_cross(r.dir, vars.e2);
 	vars.det = v3_dot(vars.e1, vars.pvec);
 	if (fabsf(vars.det) < 1e-8f)
@@ -26,3 +26,27 @@ float	hit_triangle(const t_triangle *tr, t_ray r)
 		return (t);
 	return (-1.0f);
 }
+
+void	triangle_prepare(t_triangle *tr)
+{
+	float	denom;
+
+	tr->e1 = v3_sub(tr->b, tr->a);
+	tr->e2 = v3_sub(tr->c, tr->a);
+	tr->n = v3_norm(v3_cross(tr->e1, tr->e2));
+	tr->u = v3_norm(tr->e1);
+	tr->v = v3_norm(v3_sub(tr->e2, v3_mul(tr->u, v3_dot(tr->e2, tr->u))));
+	tr->d00 = v3_dot(tr->e1, tr->e1);
+	tr->d01 = v3_dot(tr->e1, tr->e2);
+	tr->d11 = v3_dot(tr->e2, tr->e2);
+	denom = tr->d00 * tr->d11 - tr->d01 * tr->d01;
+	tr->inv_denom = 0.0f;
+	if (fabsf(denom) > 1e-12f)
+		tr->inv_denom = 1.0f / denom;
+}
+/*
+* Purpose: Derive everything hit_triangle and record_triangle need from the
+* vertices a, b, c: edges, unit normal, checker axes and the barycentric
+* setup used by bump mapping.
+* Use: Call whenever a, b or c change (parse time, transforms).
+*/
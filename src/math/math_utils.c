@@ -22,6 +22,21 @@ Lógica:
 - Si está en el rango, devuelve el valor original.
 */
 
+t_vec3	v3_rotate(t_vec3 v, t_vec3 axis, float angle)
+{
+	float	c;
+	float	s;
+
+	c = cosf(angle);
+	s = sinf(angle);
+	return (v3_add(v3_add(v3_mul(v, c), v3_mul(v3_cross(axis, v), s)),
+			v3_mul(axis, v3_dot(axis, v) * (1.0f - c))));
+}
+/*
+Propósito: Girar v un ángulo `angle` (radianes) alrededor del eje unitario
+`axis` (fórmula de Rodrigues).
+*/
+
 /*PROBAR SI CON ESTA RAIZ CUADRADA FUNCIONA MAS RÁPIDO*/
 // float q_rsqrt(float number)
 // {
@@ -5,22 +5,19 @@
 #include "../include/hit.h"
 #include "../include/shading.h"
 #include "../include/app.h"
-
-static void render_and_present(t_app *app)
-{
-	render_scene(app);
-	upload_framebuffer(app->image, app->framebuffer);
-}
+#include "../include/workers.h"
+#include "../include/accel.h"
+#include "../include/cli.h"
 
 static int init_window(t_app *app)
 {
-	app->mlx = mlx_init(WIN_W, WIN_H, "miniRT", false);
+	app->mlx = mlx_init(app->width, app->height, "miniRT", false);
 	if (!app->mlx)
 	{
 		ft_putstr_fd((char *)"Error\nmlx_init failed\n", 2);
 		return (-1);
 	}
-	app->image = mlx_new_image(app->mlx, WIN_W, WIN_H);
+	app->image = mlx_new_image(app->mlx, app->width, app->height);
 	if (!app->image)
 	{
 		ft_putstr_fd((char *)"Error\nmlx_new_image failed\n", 2);
@@ -49,24 +46,15 @@ static void cleanup(t_app *app)
 		mlx_terminate(app->mlx);
 	scene_free(&app->scene);
 	free(app->framebuffer);
+	free(app->gbuf);
 }
 
-int	main(int ac, char **av)
+static int	load_scene(t_app *app, const char *path)
 {
-	t_app			app;
 	t_parse_result	pr;
 
-	if (ac != 2)
-	{
-		ft_putstr_fd((char *)"Usage: ", 2);
-		if (av[0])
-			ft_putstr_fd(av[0], 2);
-		ft_putstr_fd((char *)" <scene.rt>\n", 2);
-		return (1);
-	}
-	ft_bzero(&app, sizeof(app));
-	scene_init(&app.scene);
-	pr = parse_scene(av[1], &app.scene);
+	scene_init(&app->scene);
+	pr = parse_scene(path, &app->scene);
 	if (!pr.ok)
 	{
 		ft_putstr_fd((char *)"Error\n", 2);
@@ -78,26 +66,63 @@ int	main(int ac, char **av)
 		else
 			ft_putstr_fd((char *)"parse failed\n", 2);
 		parse_result_free(&pr);
-		scene_free(&app.scene);
-		return (EXIT_FAILURE);
+		scene_free(&app->scene);
+		return (-1);
 	}
 	parse_result_free(&pr);
-	app.framebuffer = (uint32_t *)malloc(sizeof(uint32_t) * (size_t)WIN_W * (size_t)WIN_H);
+	if (scene_build_accel(&app->scene) < 0)
+	{
+		ft_putstr_fd((char *)"Error\nfailed to build scene BVH\n", 2);
+		scene_free(&app->scene);
+		return (-1);
+	}
+	return (0);
+}
+
+int	main(int ac, char **av)
+{
+	t_app	app;
+	t_cli	cli;
+	int		rc;
+
+	if (cli_parse(ac, av, &cli) < 0)
+		return (cli_usage(av[0]), 1);
+	ft_bzero(&app, sizeof(app));
+	app.width = cli.width;
+	app.height = cli.height;
+	if (load_scene(&app, cli.scene_path) < 0)
+		return (EXIT_FAILURE);
+	app.framebuffer = (uint32_t *)malloc(sizeof(uint32_t)
+			* (size_t)app.width * (size_t)app.height);
 	if (!app.framebuffer)
 	{
 		ft_putstr_fd((char *)"Error\nfailed to allocate framebuffer\n", 2);
 		scene_free(&app.scene);
 		return (1);
 	}
+	app.show_normals = 0;
+	app.threads = workers_default_count();
+	if (cli.output)
+	{
+		rc = app_render_to_file(&app, cli.output);
+		cleanup(&app);
+		return (rc != 0);
+	}
 	if (init_window(&app) < 0)
 	{
 		cleanup(&app);
 		return (1);
 	}
+	app.gbuf = (t_gbuf_px *)ft_calloc((size_t)app.width * (size_t)app.height,
+			sizeof(t_gbuf_px));
 	ti_init(&app.overlay, app.mlx, app.image);
-	app.show_normals = 0;
-	render_and_present(&app);
+	ft_bzero(app.framebuffer, sizeof(uint32_t)
+		* (size_t)app.width * (size_t)app.height);
+	render_invalidate(&app);
+	mlx_loop_hook(app.mlx, &render_progress_frame, &app);
 	mlx_key_hook(app.mlx, &app_on_key, &app);
+	mlx_mouse_hook(app.mlx, &app_on_mouse, &app);
+	mlx_scroll_hook(app.mlx, &app_on_scroll, &app);
 	mlx_loop(app.mlx);
 	cleanup(&app);
 	return (0);
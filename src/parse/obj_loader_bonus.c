@@ -0,0 +1,329 @@
+#include <fcntl.h>
+#include "../../include/minirt.h"
+#include "../../include/mesh_bonus.h"
+
+/* Growable vertex / index buffers filled while scanning the OBJ text. */
+typedef struct s_obj_reader
+{
+	t_vec3	*v;
+	int		vcount;
+	int		vcap;
+	int		*idx;
+	int		icount;
+	int		icap;
+}	t_obj_reader;
+
+static char	*read_all(const char *path)
+{
+	char	*buf;
+	char	*tmp;
+	size_t	len;
+	size_t	cap;
+	ssize_t	n;
+	int		fd;
+
+	fd = open(path, O_RDONLY);
+	if (fd < 0)
+		return (NULL);
+	len = 0;
+	cap = 1 << 16;
+	buf = (char *)malloc(cap + 1);
+	n = 1;
+	while (buf && n > 0)
+	{
+		if (len == cap)
+		{
+			tmp = (char *)malloc(cap * 2 + 1);
+			if (tmp)
+				ft_memcpy(tmp, buf, len);
+			free(buf);
+			buf = tmp;
+			cap *= 2;
+		}
+		if (buf)
+			n = read(fd, buf + len, cap - len);
+		if (buf && n > 0)
+			len += (size_t)n;
+	}
+	close(fd);
+	if (buf && n < 0)
+		return (free(buf), NULL);
+	if (buf)
+		buf[len] = '\0';
+	return (buf);
+}
+/*
+* Purpose: Slurp the whole OBJ into one NUL-terminated buffer so it can be
+* scanned in place, without a line-by-line allocation per vertex/face.
+*/
+
+static int	grow(void **data, int *cap, int need, size_t elem)
+{
+	void	*tmp;
+	int		ncap;
+
+	if (need <= *cap)
+		return (1);
+	ncap = 64;
+	while (ncap < need)
+		ncap *= 2;
+	tmp = malloc(elem * (size_t)ncap);
+	if (!tmp)
+		return (0);
+	if (*data)
+		ft_memcpy(tmp, *data, elem * (size_t)(*cap));
+	free(*data);
+	*data = tmp;
+	*cap = ncap;
+	return (1);
+}
+
+static int	at_value(const char **p)
+{
+	while (**p == ' ' || **p == '\t')
+		(*p)++;
+	return (**p != '\0' && **p != '\n' && **p != '\r' && **p != '#');
+}
+/*
+* Purpose: Skip blanks and tell whether another value follows on this line
+* (strtof/strtol would otherwise happily run into the next line).
+*/
+
+static int	read_vertex(t_obj_reader *rd, const char *p)
+{
+	float	c[3];
+	char	*end;
+	int		i;
+
+	i = 0;
+	while (i < 3)
+	{
+		if (!at_value(&p))
+			return (0);
+		c[i] = strtof(p, &end);
+		if (end == p)
+			return (0);
+		p = end;
+		i++;
+	}
+	if (!grow((void **)&rd->v, &rd->vcap, rd->vcount + 1, sizeof(t_vec3)))
+		return (0);
+	rd->v[rd->vcount++] = v3(c[0], c[1], c[2]);
+	return (1);
+}
+
+static int	read_index(const char **p, int vcount, int *out)
+{
+	char	*end;
+	long	idx;
+
+	idx = strtol(*p, &end, 10);
+	if (end == *p)
+		return (0);
+	if (idx < 0)
+		idx += vcount;
+	else
+		idx -= 1;
+	if (idx < 0 || idx >= vcount)
+		return (0);
+	*out = (int)idx;
+	*p = end;
+	while (**p && **p != ' ' && **p != '\t' && **p != '\n' && **p != '\r')
+		(*p)++;
+	return (1);
+}
+/*
+* Purpose: Read one face corner "v", "v/vt", "v//vn" or "v/vt/vn" and keep
+* only the position index (1-based, or negative = relative to the end).
+*/
+
+static int	read_face(t_obj_reader *rd, const char *p)
+{
+	int	first;
+	int	prev;
+	int	cur;
+	int	n;
+
+	n = 0;
+	first = 0;
+	prev = 0;
+	while (at_value(&p))
+	{
+		if (!read_index(&p, rd->vcount, &cur))
+			return (0);
+		if (n >= 2)
+		{
+			if (!grow((void **)&rd->idx, &rd->icap, rd->icount + 3,
+					sizeof(int)))
+				return (0);
+			rd->idx[rd->icount++] = first;
+			rd->idx[rd->icount++] = prev;
+			rd->idx[rd->icount++] = cur;
+		}
+		if (n == 0)
+			first = cur;
+		prev = cur;
+		n++;
+	}
+	return (n >= 3);
+}
+/*
+* Purpose: Append a face, fan-triangulating quads and larger polygons.
+*/
+
+static int	read_obj(t_obj_reader *rd, const char *p)
+{
+	int	ok;
+
+	ok = 1;
+	while (ok && *p)
+	{
+		while (*p == ' ' || *p == '\t')
+			p++;
+		if (p[0] == 'v' && (p[1] == ' ' || p[1] == '\t'))
+			ok = read_vertex(rd, p + 1);
+		else if (p[0] == 'f' && (p[1] == ' ' || p[1] == '\t'))
+			ok = read_face(rd, p + 1);
+		while (*p && *p != '\n')
+			p++;
+		if (*p)
+			p++;
+	}
+	return (ok);
+}
+/*
+* Purpose: Scan the OBJ text line by line. Only `v` and `f` records matter
+* for rendering; normals, texcoords, groups and materials are skipped.
+*/
+
+static void	place_vertices(t_vec3 *v, int n, t_vec3 pos, float scale)
+{
+	t_aabb	box;
+	t_vec3	centre;
+	int		i;
+
+	box = aabb_empty();
+	i = 0;
+	while (i < n)
+		aabb_grow(&box, v[i++]);
+	centre = v3_mul(v3_add(box.min, box.max), 0.5f);
+	i = 0;
+	while (i < n)
+	{
+		v[i] = v3_add(pos, v3_mul(v3_sub(v[i], centre), scale));
+		i++;
+	}
+}
+/*
+* Purpose: Move the model's bounding-box centre to `pos` and scale it, so
+* `pos` means the same as for the other objects (the obj_to_rt tool also
+* centres meshes).
+*/
+
+static t_tri_hot	triangle_hot(const t_obj_reader *rd, int i)
+{
+	t_tri_hot	tr;
+
+	tr.a = rd->v[rd->idx[i * 3]];
+	tr.e1 = v3_sub(rd->v[rd->idx[i * 3 + 1]], tr.a);
+	tr.e2 = v3_sub(rd->v[rd->idx[i * 3 + 2]], tr.a);
+	return (tr);
+}
+/*
+* Purpose: First vertex and edges of triangle i, the layout the hit tests
+* read.
+*/
+
+static void	prepare_triangle(t_mesh_data *m, const t_obj_reader *rd, int i,
+		t_aabb *box)
+{
+	t_tri_hot	tr;
+
+	tr = triangle_hot(rd, i);
+	m->normals[i] = v3_norm(v3_cross(tr.e1, tr.e2));
+	*box = aabb_empty();
+	aabb_grow(box, tr.a);
+	aabb_grow(box, rd->v[rd->idx[i * 3 + 1]]);
+	aabb_grow(box, rd->v[rd->idx[i * 3 + 2]]);
+	aabb_pad(box);
+}
+/*
+* Purpose: Precompute the normal and padded box of triangle i once,
+* instead of on every ray.
+*/
+
+static int	build_mesh_bvh(t_mesh_data *m, const t_obj_reader *rd)
+{
+	t_aabb		*boxes;
+	t_tri_hot	tr;
+	int			i;
+	int			ret;
+
+	boxes = (t_aabb *)malloc(sizeof(t_aabb) * (size_t)m->tri_count);
+	m->normals = (t_vec3 *)malloc(sizeof(t_vec3) * (size_t)m->tri_count);
+	if (!boxes || !m->normals)
+		return (free(boxes), -1);
+	i = 0;
+	while (i < m->tri_count)
+	{
+		prepare_triangle(m, rd, i, &boxes[i]);
+		i++;
+	}
+	ret = bvh_build_cached(&m->bvh, boxes, m->tri_count);
+	free(boxes);
+	if (ret < 0 || tri_soa_init(&m->soa, m->tri_count) < 0)
+		return (-1);
+	i = -1;
+	while (++i < m->tri_count)
+	{
+		tr = triangle_hot(rd, m->bvh.index[i]);
+		tri_soa_set(&m->soa, i, &tr);
+	}
+	m->batch = batch_ops()->tris;
+	return (0);
+}
+
+const char	*mesh_load_obj(const char *path, t_vec3 pos, float scale,
+		t_mesh_data **out)
+{
+	t_obj_reader	rd;
+	t_mesh_data		*m;
+	char			*text;
+	int				ret;
+
+	*out = NULL;
+	text = read_all(path);
+	if (!text)
+		return ("mesh: unable to open/read OBJ file");
+	ft_bzero(&rd, sizeof(rd));
+	if (!read_obj(&rd, text))
+		return (free(text), free(rd.v), free(rd.idx), "mesh: malformed OBJ");
+	free(text);
+	m = (t_mesh_data *)ft_calloc(1, sizeof(t_mesh_data));
+	if (!m || rd.icount == 0)
+		return (free(m), free(rd.v), free(rd.idx), "mesh: OBJ has no faces");
+	m->tri_count = rd.icount / 3;
+	place_vertices(rd.v, rd.vcount, pos, scale);
+	ret = build_mesh_bvh(m, &rd);
+	free(rd.v);
+	free(rd.idx);
+	if (ret < 0)
+		return (mesh_free(m), "mesh: not enough memory");
+	*out = m;
+	return (NULL);
+}
+/*
+* Purpose: Load an OBJ, place it in world space and build its BVH and hit
+* layout; the indexed buffers it was read into are freed once that is done.
+* Returns: NULL on success, or a static error message (nothing is leaked).
+*/
+
+void	mesh_free(t_mesh_data *mesh)
+{
+	if (!mesh)
+		return ;
+	bvh_free(&mesh->bvh);
+	tri_soa_free(&mesh->soa);
+	free(mesh->normals);
+	free(mesh);
+}
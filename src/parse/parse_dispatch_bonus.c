@@ -19,6 +19,8 @@ t_parse_result	dispatch_tokens(char **tokens, int line, t_scene *scene)
 		return (parse_tr(tokens, line, scene));
 	if (ft_strncmp(tokens[0], "hp", 3) == 0)
 		return (parse_hp(tokens, line, scene));
+	if (ft_strncmp(tokens[0], "mesh", 5) == 0)
+		return (parse_mesh(tokens, line, scene));
 	return (parse_error(line, "Unknown identifier"));
 }
 /*
@@ -71,26 +71,30 @@ t_parse_result	parse_c(char **tokens, int line, t_scene *scene)
 
 t_parse_result	parse_l(char **tokens, int line, t_scene *scene)
 {
+	t_light		l;
+	const char	*err;
+
 	if (!tokens[1] || !tokens[2])
 		return (parse_error(line, "L: invalid format"));
 	if (tokens[4])
 		return (parse_error(line, "L: invalid format"));
-	if (scene->light.present)
-		return (parse_error(line, "Duplicated L"));
-	scene->light.present = true;
-	scene->light.color = v3(1.0f, 1.0f, 1.0f);
-	if (!parse_vec3(tokens[1], &scene->light.pos))
+	l.color = v3(1.0f, 1.0f, 1.0f);
+	if (!parse_vec3(tokens[1], &l.pos))
 		return (parse_error(line, "L: invalid position"));
-	if (!parse_float(tokens[2], &scene->light.bright))
+	if (!parse_float(tokens[2], &l.bright))
 		return (parse_error(line, "L: invalid bright"));
-	if (scene->light.bright < 0.0f || scene->light.bright > 1.0f)
+	if (l.bright < 0.0f || l.bright > 1.0f)
 		return (parse_error(line, "L: bright out of range [0,1]"));
-	if (tokens[3] && !parse_color_255(tokens[3], &scene->light.color))
+	if (tokens[3] && !parse_color_255(tokens[3], &l.color))
 		return (parse_error(line, "L: invalid color"));
+	err = scene_add_light(scene, &l);
+	if (err)
+		return (parse_error(line, err));
 	return (parse_ok());
 }
 /*
 * Purpose: Interpret the point light definition, with optional color override.
-* Checks: Unique declaration, valid position, brightness, and optional RGB.
-* Result: Updates the scene light or reports the precise parsing failure.
+* Checks: Valid position, brightness, and optional RGB; scene_add_light
+* decides how many lights the build accepts.
+* Result: Adds the light to the scene or reports the precise parsing failure.
 */
@@ -0,0 +1,35 @@
+#include "../../libraries/libft/libft.h"
+#include "../../include/parser_internal_bonus.h"
+#include "../../include/mesh_bonus.h"
+
+t_parse_result	parse_mesh(char **tok, int line, t_scene *scene)
+{
+	t_object	*obj;
+	t_vec3		pos;
+	float		scale;
+	const char	*err;
+
+	if (!tok[1] || !tok[2] || !tok[3] || !tok[4] || tok[5])
+		return (parse_error(line, "mesh: invalid format"));
+	if (!parse_vec3(tok[2], &pos))
+		return (parse_error(line, "mesh: invalid position"));
+	if (!parse_float(tok[3], &scale) || scale <= 0.0f)
+		return (parse_error(line, "mesh: invalid scale"));
+	obj = (t_object *)ft_calloc(1, sizeof(t_object));
+	if (!obj)
+		return (parse_error(line, "mesh: not enough memory"));
+	obj->type = OBJ_MESH;
+	if (!parse_color_255(tok[4], &obj->u_obj.me.color))
+		return (free(obj), parse_error(line, "mesh: invalid color"));
+	err = mesh_load_obj(tok[1], pos, scale, &obj->u_obj.me.data);
+	if (err)
+		return (free(obj), parse_error(line, err));
+	scene_add_object(scene, obj);
+	return (parse_ok());
+}
+/*
+* Purpose: Parse `mesh <file.obj> <pos> <scale> <color>`.
+* Actions: Load the OBJ into one indexed mesh object (vertices centred on
+* `pos` and multiplied by `scale`) with its own triangle BVH.
+* Failure: Returns the loader or validation message; nothing is leaked.
+*/
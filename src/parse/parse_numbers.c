@@ -61,14 +61,14 @@ static int	parse_fraction(const char **p, double *val)
 * Behavior: Multiplies successive digits by decreasing powers of ten.
 */
 
-bool	parse_float(const char *s, float *out)
+bool	scan_float(const char **s, float *out)
 {
 	const char	*p;
 	int			neg;
 	double		val;
 	int			ok;
 
-	p = s;
+	p = *s;
 	neg = 0;
 	val = 0.0;
 	ok = 0;
@@ -77,11 +77,28 @@ bool	parse_float(const char *s, float *out)
 		ok = 1;
 	if (parse_fraction(&p, &val))
 		ok = 1;
-	if (!ok || *p != '\0')
+	if (!ok)
 		return (false);
 	if (neg)
 		val = -val;
 	*out = (float)val;
+	*s = p;
+	return (true);
+}
+/*
+* Purpose: Read a decimal float at the cursor and advance past it.
+* Success: Returns true, writes the value and leaves *s on the first
+* character after the number (a separator or the end of the token).
+* Failure: Returns false without moving the cursor if no digit is found.
+*/
+
+bool	parse_float(const char *s, float *out)
+{
+	float	v;
+
+	if (!scan_float(&s, &v) || *s != '\0')
+		return (false);
+	*out = v;
 	return (true);
 }
 /*
@@ -90,13 +107,13 @@ bool	parse_float(const char *s, float *out)
 * Failure: Returns false if format is incorrect or extra characters remain.
 */
 
-bool	parse_int_in_range(const char *s, int minv, int maxv, int *out)
+bool	scan_int_in_range(const char **s, int minv, int maxv, int *out)
 {
 	const char	*p;
 	int			neg;
 	long		value;
 
-	p = s;
+	p = *s;
 	neg = 0;
 	value = 0;
 	skip_sign(&p, &neg);
@@ -107,13 +124,26 @@ bool	parse_int_in_range(const char *s, int minv, int maxv, int *out)
 		value = value * 10 + (long)(*p - '0');
 		p++;
 	}
-	if (*p != '\0')
-		return (false);
 	if (neg)
 		value = -value;
 	if (value < (long)minv || value > (long)maxv)
 		return (false);
 	*out = (int)value;
+	*s = p;
+	return (true);
+}
+/*
+* Purpose: Read an integer at the cursor, check it lies in [minv, maxv]
+* and advance past it; the cursor does not move on failure.
+*/
+
+bool	parse_int_in_range(const char *s, int minv, int maxv, int *out)
+{
+	int	v;
+
+	if (!scan_int_in_range(&s, minv, maxv, &v) || *s != '\0')
+		return (false);
+	*out = v;
 	return (true);
 }
 /*
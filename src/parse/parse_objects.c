@@ -1,6 +1,7 @@
 #include <math.h>
 #include <stdlib.h>
 #include "../../include/parser_internal.h"
+#include "../../include/hit.h"
 
 static t_parse_result	object_error(t_object *obj, int line, const char *msg)
 {
@@ -94,7 +95,7 @@ t_parse_result	parse_cy(char **tkns, int line, t_scene *scene)
 		return (object_error(obj, line, "cy: invalid height"));
 	if (!parse_color_255(tkns[5], &obj->u_obj.cy.color))
 		return (object_error(obj, line, "cy: invalid color"));
-	
+	cylinder_prepare(&obj->u_obj.cy);
 	obj->next = NULL;
 	scene_add_object(scene, obj);
 	return (parse_ok());
@@ -3,6 +3,7 @@
 #include "../../libraries/libft/libft.h"
 #include "../../include/parser_internal_bonus.h"
 #include "../../include/bump_bonus.h"
+#include "../../include/hit_bonus.h"
 
 
 static t_parse_result	object_error(t_object *obj, int line, const char *msg)
@@ -36,7 +37,7 @@ static int	parse_optional_checker(char **tokens, int idx, int *has_checker, floa
 }
 
 static int parse_optional_bump(char **tokens, int idx, int *has_bump,
-		float *out_strength, t_bumpmap **out_bump)
+		float *out_strength, t_bumpmap **out_bump, t_scene *scene)
 {
 	*has_bump = 0;
 	*out_bump = NULL;
@@ -48,27 +49,21 @@ static int parse_optional_bump(char **tokens, int idx, int *has_bump,
 		return (0);
 	if (!parse_float(tokens[idx + 2], out_strength) || *out_strength < 0.0f)
 		return (0);
-	*out_bump = bump_load_png(tokens[idx + 1]);
+	*out_bump = bump_acquire(&scene->bumps, tokens[idx + 1]);
 	if (!*out_bump)
 		return (0);
 	*has_bump = 1;
 	return (1);
 }
 
-static bool parse_material_tokens(char **tokens, t_material *mat, t_object *obj, int line)
+static bool parse_material_tokens(char **tokens, t_material *mat)
 {
 	if (!tokens || !tokens[0] || !tokens[1])
         return (false);
 	if(!parse_float(tokens[0], &mat->ks))
-	{
-		object_error(obj, line, "invalid ks");
 		return(false);
-	}	
 	if(!parse_float(tokens[1], &mat->shininess))
-	{
-		object_error(obj, line, "invalid shininess");
 		return(false);
-	}
 	return (true);
 }
 
@@ -83,8 +78,8 @@ static t_parse_result parse_specular_info(char **tokens, t_material **out_mat, t
 			return (object_error(obj, line, "missing shininess after ks"));
 	*out_mat = malloc(sizeof(**out_mat));
 	if (!*out_mat)
-		return (parse_error(line, "not enough memory for material"));
-	if (!parse_material_tokens(&tokens[0], *out_mat, obj, line))
+		return (object_error(obj, line, "not enough memory for material"));
+	if (!parse_material_tokens(&tokens[0], *out_mat))
 	{
 		free(*out_mat);
 		*out_mat = NULL;
@@ -117,7 +112,7 @@ t_parse_result	parse_sp_bo(char **tokens, int line, t_scene *scene)
 	obj->u_obj.sp.bump = NULL;
 	if (tokens[4] && ft_strncmp(tokens[4], "bm", 2) == 0)
 		done = parse_optional_bump(tokens, 4, &obj->u_obj.sp.has_bump,
-				&obj->u_obj.sp.bump_strength, &obj->u_obj.sp.bump);
+				&obj->u_obj.sp.bump_strength, &obj->u_obj.sp.bump, scene);
 	else if (tokens[4] && ft_strncmp(tokens[4], "cb", 2) == 0)
 		done = parse_optional_checker(tokens, 4, &obj->u_obj.sp.has_checker,
 				&obj->u_obj.sp.checker_scale);
@@ -191,7 +186,7 @@ t_parse_result	parse_pl_bo(char **tokens, int line, t_scene *scene)
 	if (tokens[4] && ft_strncmp(tokens[4], "bm", 2) == 0)
 	{
 		if (!parse_optional_bump(tokens, 4, &obj->u_obj.pl.has_bump,
-				&obj->u_obj.pl.bump_strength, &obj->u_obj.pl.bump))
+				&obj->u_obj.pl.bump_strength, &obj->u_obj.pl.bump, scene))
 			return (object_error(obj, line, "pl: invalid bump (bm <png> <strength>)"));
 	}
 	else if (tokens[4] && ft_strncmp(tokens[4], "cb", 2) == 0)
@@ -227,7 +222,7 @@ t_parse_result	parse_cy_bo(char **tkns, int line, t_scene *scene)
 {
 	t_object	*obj;
 
-	if (!tkns[1] || !tkns[2] || !tkns[3] || !tkns[4] || !tkns[5] || tkns[6])
+	if (!tkns[1] || !tkns[2] || !tkns[3] || !tkns[4] || !tkns[5])
 		return (parse_error(line, "cy: invalid format"));
 	obj = (t_object *)malloc(sizeof(t_object));
 	if (!obj)
@@ -247,16 +242,33 @@ t_parse_result	parse_cy_bo(char **tkns, int line, t_scene *scene)
 		return (object_error(obj, line, "cy: invalid height"));
 	if (!parse_color_255(tkns[5], &obj->u_obj.cy.color))
 		return (object_error(obj, line, "cy: invalid color"));
-	    /* determine where ks/shininess appear after optional bm/cb */
-    int next_idx;
-    if (obj->u_obj.cy.has_bump)
-        next_idx = 7; /* bm: tokens 4(path) 5(strength) 6 -> ks at 7 */
-    //else if (obj->u_obj.cy.has_checker)
-        //next_idx = 6; /* cb: tokens 4(cb) 5(scale) -> ks at 6
-    else
+	cylinder_prepare(&obj->u_obj.cy);
+	obj->u_obj.cy.has_checker = 0;
+	obj->u_obj.cy.checker_scale = 1.0f; // also used as UV scale for bump
+	if (tkns[6] && ft_strncmp(tkns[6], "bm", 2) == 0)
 	{
-        next_idx = 4; /* no optional -> ks at 4 */
+		if (!parse_optional_bump(tkns, 6, &obj->u_obj.cy.has_bump,
+				&obj->u_obj.cy.bump_strength, &obj->u_obj.cy.bump, scene))
+			return (object_error(obj, line, "cy: invalid bump (bm <png> <strength>)"));
 	}
+	else
+	{
+		obj->u_obj.cy.has_bump = 0;
+		obj->u_obj.cy.bump_strength = 0.0f;
+		obj->u_obj.cy.bump = NULL;
+		if (tkns[6] && ft_strncmp(tkns[6], "cb", 2) == 0
+			&& !parse_optional_checker(tkns, 6, &obj->u_obj.cy.has_checker,
+				&obj->u_obj.cy.checker_scale))
+			return (object_error(obj, line, "cy: invalid checker (cb <scale>)"));
+	}
+	/* determine where ks/shininess appear after optional bm/cb */
+	int next_idx;
+	if (obj->u_obj.cy.has_bump)
+		next_idx = 9; /* bm: tokens 6(bm) 7(path) 8(strength) -> ks at 9 */
+	else if (obj->u_obj.cy.has_checker)
+		next_idx = 8; /* cb: tokens 6(cb) 7(scale) -> ks at 8 */
+	else
+		next_idx = 6; /* no optional -> ks at 6 */
 	t_parse_result parse_specular = parse_specular_info(&tkns[next_idx], &obj->u_obj.cy.material, obj, line);
 	if (!parse_specular.ok)
 			return (parse_specular);
@@ -266,7 +278,8 @@ t_parse_result	parse_cy_bo(char **tkns, int line, t_scene *scene)
 }
 /*
 * Purpose: Read a cylinder entry, checking axis normalization and dimensions.
-* Actions: Allocate, parse center/axis/diameter/height/color, then link object.
+* Actions: Allocate, parse center/axis/diameter/height/color and the same
+* optional bm/cb and ks/shininess tokens as the other shapes, then link.
 * Failure: Returns descriptive parse_error while freeing allocated memory.
 */
 
@@ -307,36 +320,20 @@ static t_parse_result	hp_parse_attributes(char **tok, int line, t_object *obj)
 	return (parse_ok());
 }
 
-static void	hp_finalize(t_hparab *hp)
-{
-	t_vec3	up;
-
-	up = v3(0.0f, 1.0f, 0.0f);
-	if (fabsf(v3_dot(hp->axis, up)) > 0.999f)
-		up = v3(1.0f, 0.0f, 0.0f);
-	hp->u = v3_norm(v3_cross(up, hp->axis));
-	hp->v = v3_norm(v3_cross(hp->axis, hp->u));
-	// Use full height as the half-height clamp to avoid overly tight vertical clipping
-	// This better matches the intended "Pringles" shape extent along the axis
-	hp->half_height = hp->height;
-	hp->inv_rx2 = 1.0f / (hp->rx * hp->rx);
-	hp->inv_ry2 = 1.0f / (hp->ry * hp->ry);
-	hp->inv_height = 1.0f / hp->height;
-}
-
 t_parse_result	parse_hp(char **tok, int line, t_scene *scene)
 {
 	t_object		*obj;
 	t_parse_result	result;
 	int				cbcons;
 
+	obj = NULL;
 	result = hp_create_object(tok, line, &obj);
 	if (!result.ok)
 		return (result);
 	result = hp_parse_attributes(tok, line, obj);
 	if (!result.ok)
 		return (result);
-	hp_finalize(&obj->u_obj.hp);
+	hparab_prepare(&obj->u_obj.hp);
     obj->u_obj.hp.has_checker = 0;
     obj->u_obj.hp.checker_scale = 1.0f; // also used as UV scale for bump
     obj->u_obj.hp.has_bump = 0;
@@ -345,10 +342,10 @@ t_parse_result	parse_hp(char **tok, int line, t_scene *scene)
     if (tok[7] && ft_strncmp(tok[7], "bm", 3) == 0)
     {
 	if (!parse_optional_bump(tok, 7, &obj->u_obj.hp.has_bump,
-		&obj->u_obj.hp.bump_strength, &obj->u_obj.hp.bump))
+		&obj->u_obj.hp.bump_strength, &obj->u_obj.hp.bump, scene))
 	    return (object_error(obj, line, "hp: invalid bump (bm <png> <strength>)"));
     }
-    else
+    else if (tok[7] && ft_strncmp(tok[7], "cb", 3) == 0)
     {
 		cbcons = parse_optional_checker(tok, 7, &obj->u_obj.hp.has_checker,
 		&obj->u_obj.hp.checker_scale);
@@ -358,12 +355,12 @@ t_parse_result	parse_hp(char **tok, int line, t_scene *scene)
 	    /* determine where ks/shininess appear after optional bm/cb */
     int next_idx;
     if (obj->u_obj.hp.has_bump)
-        next_idx = 7; /* bm: tokens 4(path) 5(strength) 6 -> ks at 7 */
+        next_idx = 10; /* bm: tokens 7(bm) 8(path) 9(strength) -> ks at 10 */
     else if (obj->u_obj.hp.has_checker)
-        next_idx = 6; /* cb: tokens 4(cb) 5(scale) -> ks at 6 */
+        next_idx = 9; /* cb: tokens 7(cb) 8(scale) -> ks at 9 */
     else
 	{
-        next_idx = 4; /* no optional -> ks at 4 */
+        next_idx = 7; /* no optional -> ks at 7 */
 	}
 	t_parse_result parse_specular = parse_specular_info(&tok[next_idx], &obj->u_obj.hp.material, obj, line);
 	if (!parse_specular.ok)
@@ -377,8 +374,6 @@ t_parse_result	parse_tr(char **tokens, int line, t_scene *scene)
 {
 	t_object	*obj;
 	int			cbcons;
-	t_vec3		e1;
-	t_vec3		e2;
 
 	if (!tokens[1] || !tokens[2] || !tokens[3] || !tokens[4])
 		return (parse_error(line, "tr: invalid format"));
@@ -394,12 +389,7 @@ t_parse_result	parse_tr(char **tokens, int line, t_scene *scene)
 		return (object_error(obj, line, "tr: invalid vertex c"));
 	if (!parse_color_255(tokens[4], &obj->u_obj.tr.color))
 		return (object_error(obj, line, "tr: invalid color"));
-	{
-		e1 = v3_sub(obj->u_obj.tr.b, obj->u_obj.tr.a);
-		e2 = v3_sub(obj->u_obj.tr.c, obj->u_obj.tr.a);
-		obj->u_obj.tr.u = v3_norm(e1);
-		obj->u_obj.tr.v = v3_norm(v3_sub(e2, v3_mul(obj->u_obj.tr.u, v3_dot(e2, obj->u_obj.tr.u))));
-	}
+	triangle_prepare(&obj->u_obj.tr);
     obj->u_obj.tr.has_checker = 0;
     obj->u_obj.tr.checker_scale = 1.0f;
     obj->u_obj.tr.has_bump = 0;
@@ -408,10 +398,10 @@ t_parse_result	parse_tr(char **tokens, int line, t_scene *scene)
     if (tokens[5] && ft_strncmp(tokens[5], "bm", 3) == 0)
     {
 	if (!parse_optional_bump(tokens, 5, &obj->u_obj.tr.has_bump,
-		&obj->u_obj.tr.bump_strength, &obj->u_obj.tr.bump))
+		&obj->u_obj.tr.bump_strength, &obj->u_obj.tr.bump, scene))
 	    return (object_error(obj, line, "tr: invalid bump (bm <png> <strength>)"));
     }
-    else
+    else if (tokens[5] && ft_strncmp(tokens[5], "cb", 3) == 0)
     {
 	cbcons = parse_optional_checker(tokens, 5, &obj->u_obj.tr.has_checker,
 		&obj->u_obj.tr.checker_scale);
@@ -422,12 +412,12 @@ t_parse_result	parse_tr(char **tokens, int line, t_scene *scene)
 	    /* determine where ks/shininess appear after optional bm/cb */
     int next_idx;
     if (obj->u_obj.tr.has_bump)
-        next_idx = 7; /* bm: tokens 4(path) 5(strength) 6 -> ks at 7 */
+        next_idx = 8; /* bm: tokens 5(bm) 6(path) 7(strength) -> ks at 8 */
     else if (obj->u_obj.tr.has_checker)
-        next_idx = 6; /* cb: tokens 4(cb) 5(scale) -> ks at 6 */
+        next_idx = 7; /* cb: tokens 5(cb) 6(scale) -> ks at 7 */
     else
 	{
-        next_idx = 4; /* no optional -> ks at 4 */
+        next_idx = 5; /* no optional -> ks at 5 */
 	}
 	t_parse_result parse_specular = parse_specular_info(&tokens[next_idx], &obj->u_obj.tr.material, obj, line);
 	if (!parse_specular.ok)
@@ -0,0 +1,243 @@
+#include <stdatomic.h>
+#include <stdlib.h>
+#include "../../libraries/libft/libft.h"
+#include "../../include/parser_internal.h"
+#include "../../include/workers.h"
+
+/* Chunks per thread, so a slow chunk does not leave the others idle. */
+#define PARSE_CHUNKS_PER_THREAD	4
+/* Smallest chunk worth handing to a thread. */
+#define PARSE_CHUNK_MIN			262144
+
+/*
+* A line set aside for the serial pass: its offset in the chunk and its
+* 0-based line index within the chunk.
+*/
+typedef struct s_deferred
+{
+	size_t	off;
+	size_t	line;
+}	t_deferred;
+
+/*
+* One newline-aligned slice of the mapped file.
+* scene: objects (and bump maps) parsed from it by a worker.
+* lines: lines read; result: first error, its line relative to the chunk.
+* defer: A, C and L lines, left to the serial pass.
+*/
+typedef struct s_parse_chunk
+{
+	const char		*start;
+	size_t			size;
+	size_t			lines;
+	t_scene			scene;
+	t_parse_result	result;
+	t_deferred		*defer;
+	int				ndefer;
+	int				defer_cap;
+}	t_parse_chunk;
+
+typedef struct s_parse_job
+{
+	t_parse_chunk	*chunks;
+	int				count;
+	atomic_int		next;
+}	t_parse_job;
+
+static int	is_element(const char *s)
+{
+	while (*s == ' ' || *s == '\t')
+		s++;
+	if (*s != 'A' && *s != 'C' && *s != 'L')
+		return (0);
+	s++;
+	return (*s == '\0' || *s == ' ' || *s == '\t' || *s == '#');
+}
+/*
+* Purpose: Tell the A, C and L lines apart: they must be counted across
+* the whole file, so workers leave them for the serial pass.
+*/
+
+static t_parse_result	defer_line(t_parse_chunk *ck, size_t off)
+{
+	t_deferred	*grown;
+
+	if (ck->ndefer == ck->defer_cap)
+	{
+		ck->defer_cap = ck->defer_cap * 2 + 4;
+		grown = (t_deferred *)malloc(sizeof(t_deferred)
+				* (size_t)ck->defer_cap);
+		if (!grown)
+			return (parse_error((int)(ck->lines + 1), "not enough memory"));
+		if (ck->ndefer)
+			ft_memcpy(grown, ck->defer, sizeof(t_deferred)
+				* (size_t)ck->ndefer);
+		free(ck->defer);
+		ck->defer = grown;
+	}
+	ck->defer[ck->ndefer].off = off;
+	ck->defer[ck->ndefer].line = ck->lines;
+	ck->ndefer++;
+	return (parse_ok());
+}
+
+static void	parse_chunk(t_parse_chunk *ck)
+{
+	t_line_reader	rd;
+	char			line[PARSE_LINE_MAX];
+	size_t			off;
+	int				got;
+
+	reader_view(&rd, ck->start, ck->size);
+	scene_init(&ck->scene);
+	ck->result = parse_ok();
+	off = rd.pos;
+	got = reader_next(&rd, line);
+	while (got > 0 && ck->result.ok)
+	{
+		if (is_element(line))
+			ck->result = defer_line(ck, off);
+		else
+			ck->result = parse_line(line, (int)(ck->lines + 1), &ck->scene);
+		ck->lines++;
+		off = rd.pos;
+		got = reader_next(&rd, line);
+	}
+	if (got < 0 && ck->result.ok)
+		ck->result = parse_error((int)(ck->lines + 1), rd.err);
+}
+/*
+* Purpose: Parse the object lines of one chunk into its own scene and note
+* where its A, C and L lines are. Stops at the chunk's first error.
+*/
+
+static void	*chunk_worker(void *ctx)
+{
+	t_parse_job	*job;
+	int			i;
+
+	job = (t_parse_job *)ctx;
+	i = atomic_fetch_add(&job->next, 1);
+	while (i < job->count)
+	{
+		parse_chunk(&job->chunks[i]);
+		i = atomic_fetch_add(&job->next, 1);
+	}
+	return (NULL);
+}
+
+static int	split_chunks(t_parse_job *job, const t_line_reader *rd,
+		int threads)
+{
+	size_t		cut;
+	size_t		end;
+	const char	*nl;
+	int			i;
+
+	job->count = threads * PARSE_CHUNKS_PER_THREAD;
+	if ((size_t)job->count > rd->size / PARSE_CHUNK_MIN)
+		job->count = (int)(rd->size / PARSE_CHUNK_MIN);
+	if (job->count < 1)
+		job->count = 1;
+	job->chunks = (t_parse_chunk *)ft_calloc((size_t)job->count,
+			sizeof(t_parse_chunk));
+	if (!job->chunks)
+		return (0);
+	cut = 0;
+	i = -1;
+	while (++i < job->count)
+	{
+		end = rd->size;
+		if (i < job->count - 1)
+		{
+			end = rd->size / (size_t)job->count * (size_t)(i + 1);
+			if (end < cut)
+				end = cut;
+			nl = ft_memchr(rd->map + end, '\n', rd->size - end);
+			end = rd->size;
+			if (nl)
+				end = (size_t)(nl - rd->map) + 1;
+		}
+		job->chunks[i].start = rd->map + cut;
+		job->chunks[i].size = end - cut;
+		cut = end;
+	}
+	return (1);
+}
+/*
+* Purpose: Cut the mapped file into chunks of whole lines, about
+* PARSE_CHUNKS_PER_THREAD per thread and none under PARSE_CHUNK_MIN bytes.
+*/
+
+static t_parse_result	replay(const t_parse_chunk *ck, size_t base,
+		t_scene *scene)
+{
+	t_line_reader	rd;
+	char			line[PARSE_LINE_MAX];
+	t_parse_result	result;
+	int				i;
+
+	i = -1;
+	while (++i < ck->ndefer)
+	{
+		if (!ck->result.ok
+			&& ck->defer[i].line + 1 >= (size_t)ck->result.line)
+			break ;
+		reader_view(&rd, ck->start + ck->defer[i].off,
+			ck->size - ck->defer[i].off);
+		reader_next(&rd, line);
+		result = parse_line(line, (int)(base + ck->defer[i].line + 1), scene);
+		if (!result.ok)
+			return (result);
+	}
+	return (parse_ok());
+}
+/*
+* Purpose: Parse a chunk's A, C and L lines into the real scene, in file
+* order, up to the chunk's own first error.
+* Notes: `base` is the number of lines in the chunks before this one, so
+* messages carry the line number of the file.
+*/
+
+t_parse_result	parse_parallel(const t_line_reader *rd, t_scene *scene,
+		int threads)
+{
+	t_parse_job		job;
+	t_parse_result	result;
+	size_t			base;
+	int				i;
+
+	if (!split_chunks(&job, rd, threads))
+		return (parse_error(0, "not enough memory"));
+	atomic_init(&job.next, 0);
+	workers_run(threads, chunk_worker, &job);
+	result = parse_ok();
+	base = 0;
+	i = -1;
+	while (++i < job.count)
+	{
+		scene_adopt(scene, &job.chunks[i].scene);
+		if (result.ok)
+			result = replay(&job.chunks[i], base, scene);
+		if (result.ok && !job.chunks[i].result.ok)
+		{
+			result = job.chunks[i].result;
+			result.line += (int)base;
+			job.chunks[i].result = parse_ok();
+		}
+		parse_result_free(&job.chunks[i].result);
+		free(job.chunks[i].defer);
+		base += job.chunks[i].lines;
+	}
+	free(job.chunks);
+	return (result);
+}
+/*
+* Purpose: Parse a large mapped scene on `threads` threads with the same
+* outcome as the line-by-line pass.
+* Logic: Workers parse the object lines of each chunk into a scene of
+* their own. The chunks are then merged in file order: their objects are
+* spliced into the scene, their A, C and L lines are parsed there (so the
+* declared-once checks see the whole file), and the first error in file
+* order, whichever chunk raised it, is the one reported.
+*/
@@ -1,64 +1,51 @@
-#include <stdlib.h>
 #include <math.h>
-#include "../../libraries/libft/libft.h"
 #include "../../include/parser_internal.h"
 
+static bool	scan_comma(const char **p)
+{
+	if (**p != ',')
+		return (false);
+	(*p)++;
+	return (true);
+}
+
 bool	parse_vec3(const char *s, t_vec3 *out)
 {
-	char	**tokens;
-	size_t	index;
 	float	values[3];
 
-	tokens = ft_split(s, ',');
-	if (!tokens)
+	if (!scan_float(&s, &values[0]) || !scan_comma(&s)
+		|| !scan_float(&s, &values[1]) || !scan_comma(&s)
+		|| !scan_float(&s, &values[2]) || *s != '\0')
 		return (false);
-	if (!tokens[0] || !tokens[1] || !tokens[2] || tokens[3])
-		return (free_tokens(tokens), false);
-	index = 0;
-	while (index < 3)
-	{
-		if (!parse_float(tokens[index], &values[index]))
-			return (free_tokens(tokens), false);
-		index++;
-	}
 	out->x = values[0];
 	out->y = values[1];
 	out->z = values[2];
-	return (free_tokens(tokens), true);
+	return (true);
 }
 /*
 * Purpose: Parse a "x,y,z" triple into a `t_vec3` with floating components.
 * Success: Fills `out` when exactly three valid floats are provided.
-* Failure: Returns false if allocation fails or the string is malformed.
+* Failure: Returns false if the string is malformed (`out` is untouched).
+* Notes: Read with a cursor over the token, no sub-string is allocated.
 */
 
 bool	parse_color_255(const char *s, t_vec3 *out)
 {
-	char	**tokens;
-	size_t	index;
 	int		values[3];
 
-	tokens = ft_split(s, ',');
-	if (!tokens)
+	if (!scan_int_in_range(&s, 0, 255, &values[0]) || !scan_comma(&s)
+		|| !scan_int_in_range(&s, 0, 255, &values[1]) || !scan_comma(&s)
+		|| !scan_int_in_range(&s, 0, 255, &values[2]) || *s != '\0')
 		return (false);
-	if (!tokens[0] || !tokens[1] || !tokens[2] || tokens[3])
-		return (free_tokens(tokens), false);
-	index = 0;
-	while (index < 3)
-	{
-		if (!parse_int_in_range(tokens[index], 0, 255, &values[index]))
-			return (free_tokens(tokens), false);
-		index++;
-	}
 	out->x = (float)values[0] / 255.0f;
 	out->y = (float)values[1] / 255.0f;
 	out->z = (float)values[2] / 255.0f;
-	return (free_tokens(tokens), true);
+	return (true);
 }
 /*
 * Purpose: Decode an RGB triplet in 0..255 and map it to normalized floats.
 * Success: Populates `out` with values scaled to the [0,1] range.
-* Failure: Returns false on allocation errors or invalid integer components.
+* Failure: Returns false on invalid integer components or separators.
 */
 
 bool	vec3_is_normalized(t_vec3 v)
@@ -1,4 +1,5 @@
 #include "../../include/parser_internal.h"
+#include "../../include/workers.h"
 #include "../../libraries/libft/libft.h"
 
 static int	validate_extension(const char *path)
@@ -35,81 +36,83 @@ static char	*prepare_line(char *line)
 * Returns: Pointer to the first significant character within the original line.
 */
 
-static t_parse_result	process_line(char *line, size_t index, t_scene *scene)
+t_parse_result	parse_line(char *line, int line_no, t_scene *scene)
 {
-	char			**tokens;
-	t_parse_result	result;
+	char	*tokens[PARSE_MAX_TOKENS + 1];
+	int		count;
 
-	tokens = split_ws(line);
-	if (!tokens)
-		return (parse_error((int)(index + 1), "split failed"));
-	if (!tokens[0])
-	{
-		free_tokens(tokens);
+	count = split_ws(prepare_line(line), tokens, PARSE_MAX_TOKENS);
+	if (count < 0)
+		return (parse_error(line_no, "too many fields"));
+	if (count == 0)
 		return (parse_ok());
-	}
-	result = dispatch_tokens(tokens, (int)(index + 1), scene);
-	free_tokens(tokens);
-	return (result);
+	return (dispatch_tokens(tokens, line_no, scene));
 }
 /*
-* Purpose: Tokenize a meaningful line and dispatch it to the appropriate parser.
-* Errors: Converts allocation issues or parsing failures into structured results.
+* Purpose: Tokenize one line and dispatch it to the appropriate parser;
+* blank and comment-only lines are accepted as they are.
+* Notes: Tokens are cut in place in the line and listed in a stack array, so
+* a line costs no allocation of its own.
 */
 
-static t_parse_result	parse_lines(char **lines, size_t count, t_scene *scene)
+static t_parse_result	parse_lines(t_line_reader *rd, t_scene *scene)
 {
 	size_t			index;
-	char			*trimmed;
+	char			line[PARSE_LINE_MAX];
 	t_parse_result	result;
+	int				got;
 
 	index = 0;
-	while (index < count)
+	got = reader_next(rd, line);
+	while (got > 0)
 	{
-		trimmed = prepare_line(lines[index]);
-		if (*trimmed != '\0')
-		{
-			result = process_line(trimmed, index, scene);
-			if (!result.ok)
-				return (result);
-		}
+		result = parse_line(line, (int)(index + 1), scene);
+		if (!result.ok)
+			return (result);
 		index++;
+		got = reader_next(rd, line);
 	}
+	if (got < 0)
+		return (parse_error((int)(index + 1), rd->err));
 	return (parse_ok());
 }
 /*
 * Purpose: Iterate over every line of the input file,
 * skipping blanks and comments.
-* Workflow: Normalizes each line, delegates meaningful ones,
-* and stops on errors.
+* Workflow: Each line is copied into a stack buffer and parsed; stops on
+* errors.
 */
 
 t_parse_result	parse_scene(const char *path, t_scene *scene)
 {
-	char			**lines;
-	size_t			count;
+	t_line_reader	rd;
 	t_parse_result	result;
+	int				threads;
 
-	if (!validate_extension(path))
+	if (ft_strncmp(path, "-", 2) != 0 && !validate_extension(path))
 		return (parse_error(0, "The file does not have .rt extension"));
 	scene_init(scene);
-	count = 0;
-	lines = read_file_lines(path, &count);
-	if (!lines)
+	if (reader_open(&rd, path) < 0)
 		return (parse_error(0, "Unable to open/read file"));
-	result = parse_lines(lines, count, scene);
+	threads = 1;
+	if (rd.map && rd.size >= PARSE_PAR_MIN)
+		threads = workers_default_count();
+	if (threads > 1)
+		result = parse_parallel(&rd, scene, threads);
+	else
+		result = parse_lines(&rd, scene);
+	reader_close(&rd);
 	if (result.ok)
 	{
 		if (!scene->ambient.present)
 			result = parse_error(0, "Missing Ambient (A)");
 		else if (!scene->camera.present)
 			result = parse_error(0, "Missing Camera (C)");
-		else if (!scene->light.present)
+		else if (scene->light_count == 0)
 			result = parse_error(0, "Missing Light (L)");
 	}
 	if (!result.ok)
 		scene_free(scene);
-	free_lines(lines, count);
 	return (result);
 }
 /*
@@ -117,4 +120,6 @@ t_parse_result	parse_scene(const char *path, t_scene *scene)
 * and builds the scene.
 * Guarantees: Initializes the scene, enforces required entities,
 * and cleans on failure.
+* Notes: A path of "-" reads the scene from standard input. Files of
+* PARSE_PAR_MIN bytes or more are parsed on MINIRT_THREADS threads.
 */
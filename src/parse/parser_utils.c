@@ -1,125 +1,162 @@
-#include <stdlib.h>
 #include <fcntl.h>
 #include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include "../../libraries/libft/libft.h"
-#include "../../libraries/get_next_line/get_next_line.h"
 #include "../../include/parser_internal.h"
 
-static void	chomp_line(char *line)
+static void	map_file(t_line_reader *rd)
 {
-	size_t	len;
+	struct stat	st;
+	void		*p;
 
-	len = ft_strlen(line);
-	while (len > 0 && (line[len - 1] == '\n' || line[len - 1] == '\r'))
-	{
-		len--;
-		line[len] = '\0';
-	}
+	if (fstat(rd->fd, &st) < 0 || !S_ISREG(st.st_mode) || st.st_size <= 0)
+		return ;
+	p = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, rd->fd, 0);
+	if (p == MAP_FAILED)
+		return ;
+	madvise(p, (size_t)st.st_size, MADV_SEQUENTIAL);
+	rd->map = (const char *)p;
+	rd->size = (size_t)st.st_size;
 }
 /*
-* Purpose: Strip trailing newline and carriage-return characters from a line.
-* Context: Ensures parser logic works with clean strings from get_next_line.
+* Purpose: Map a regular file read-only so lines are scanned where the
+* kernel's page cache holds them, without copying the file.
+* Notes: Leaves rd->map NULL for pipes, terminals and empty files, which
+* are then read through the streaming buffer.
 */
 
-static int	append_line(t_list **lst, char *line)
+int	reader_open(t_line_reader *rd, const char *path)
 {
-	t_list	*node;
+	ft_bzero(rd, sizeof(*rd));
+	rd->fd = 0;
+	if (ft_strncmp(path, "-", 2) != 0)
+		rd->fd = open(path, O_RDONLY);
+	if (rd->fd < 0)
+		return (-1);
+	map_file(rd);
+	return (0);
+}
+/*
+* Purpose: Open the scene source: a file path, or "-" for standard input.
+* Returns: 0 on success, -1 when the file cannot be opened.
+*/
 
-	node = ft_lstnew(line);
-	if (!node)
-		return (0);
-	ft_lstadd_back(lst, node);
-	return (1);
+void	reader_view(t_line_reader *rd, const char *data, size_t size)
+{
+	rd->fd = -1;
+	rd->map = data;
+	rd->size = size;
+	rd->pos = 0;
+	rd->err = NULL;
 }
 /*
-* Purpose: Push a freshly read line into a temporary linked list.
-* Returns: 1 on success, 0 on allocation failure (caller cleans up).
+* Purpose: Read lines out of bytes already in memory, such as one chunk of
+* a mapped file.
+* Notes: The bytes are borrowed; a view is never passed to reader_close.
 */
 
-static int	read_lines_fd(int fd, t_list **lst, size_t *count)
+void	reader_close(t_line_reader *rd)
+{
+	if (rd->map)
+		munmap((void *)rd->map, rd->size);
+	if (rd->fd > 0)
+		close(rd->fd);
+	rd->map = NULL;
+	rd->fd = -1;
+}
+
+static int	fill(t_line_reader *rd)
 {
-	char	*line;
+	ssize_t	n;
 
-	line = get_next_line(fd);
-	while (line)
+	if (rd->pos > 0)
 	{
-		chomp_line(line);
-		if (!append_line(lst, line))
-		{
-			free(line);
-			return (0);
-		}
-		*count = *count + 1;
-		line = get_next_line(fd);
+		ft_memmove(rd->buf, rd->buf + rd->pos, rd->size - rd->pos);
+		rd->size -= rd->pos;
+		rd->pos = 0;
 	}
+	n = read(rd->fd, rd->buf + rd->size, sizeof(rd->buf) - rd->size);
+	if (n < 0)
+		rd->err = "Unable to read file";
+	if (n <= 0)
+		return ((int)n);
+	rd->size += (size_t)n;
 	return (1);
 }
 /*
-* Purpose: Load every line from the file descriptor into a list of strings.
-* Behavior: Tracks the total count and stops gracefully on allocation errors.
+* Purpose: Streaming mode: keep the unread tail at the front of the buffer
+* and append what the next read() returns.
+* Returns: 1 when bytes were added, 0 at end of input, -1 on read error.
 */
 
-static char	**list_to_array(t_list *lst, size_t count)
+static const char	*find_line(t_line_reader *rd, size_t *len)
 {
-	char	**lines;
-	size_t	index;
+	const char	*base;
+	const char	*nl;
+	int			got;
 
-	lines = (char **)malloc(sizeof(char *) * count);
-	if (!lines)
-		return (NULL);
-	index = 0;
-	while (index < count)
+	base = rd->map;
+	if (!base)
+		base = rd->buf;
+	nl = ft_memchr(base + rd->pos, '\n', rd->size - rd->pos);
+	while (!nl && !rd->map && rd->size - rd->pos < sizeof(rd->buf))
 	{
-		lines[index] = ft_strdup((char *)lst->content);
-		if (!lines[index])
-		{
-			while (index > 0)
-			{
-				index--;
-				free(lines[index]);
-			}
-			free(lines);
+		got = fill(rd);
+		if (got < 0)
 			return (NULL);
-		}
-		lst = lst->next;
-		index++;
+		if (got == 0)
+			break ;
+		nl = ft_memchr(rd->buf + rd->pos, '\n', rd->size - rd->pos);
 	}
-	return (lines);
+	if (rd->pos == rd->size)
+		return (NULL);
+	*len = rd->size - rd->pos;
+	if (nl)
+		*len = (size_t)(nl - (base + rd->pos));
+	else if (!rd->map && *len == sizeof(rd->buf))
+		*len = PARSE_LINE_MAX;
+	return (base + rd->pos);
 }
 /*
-* Purpose: Materialize the linked-list buffer into a contiguous array of lines.
-* Guarantees: Duplicates each string and frees partial allocations on failure.
+* Purpose: Locate the next line: in the mapping, or in the buffer after
+* reading until it holds a newline (or the input ends).
+* Returns: Its start and length without the '\n', or NULL at end of input
+* or on error (rd->err set).
 */
 
-char	**read_file_lines(const char *path, size_t *out_count)
+int	reader_next(t_line_reader *rd, char *line)
 {
-	int		fd;
-	t_list	*lst;
-	size_t	count;
-	char	**lines;
+	const char	*src;
+	size_t		len;
 
-	fd = open(path, O_RDONLY);
-	if (fd < 0)
-		return (NULL);
-	lst = NULL;
-	count = 0;
-	if (!read_lines_fd(fd, &lst, &count))
+	src = find_line(rd, &len);
+	if (!src)
 	{
-		close(fd);
-		ft_lstclear(&lst, free);
-		return (NULL);
+		if (rd->err)
+			return (-1);
+		return (0);
 	}
-	close(fd);
-	lines = list_to_array(lst, count);
-	ft_lstclear(&lst, free);
-	if (!lines)
-		return (NULL);
-	if (out_count)
-		*out_count = count;
-	return (lines);
+	if (len >= PARSE_LINE_MAX)
+	{
+		rd->err = "line too long";
+		return (-1);
+	}
+	ft_memcpy(line, src, len);
+	rd->pos += len + 1;
+	if (rd->pos > rd->size)
+		rd->pos = rd->size;
+	while (len > 0 && (line[len - 1] == '\r'))
+		len--;
+	line[len] = '\0';
+	return (1);
 }
 /*
-* Purpose: Read an entire file into a NULL-terminated array of strings.
-* Outcome: Provides ownership of the array to the caller with optional count.
-* Failure: Returns NULL and leaves cleanup to the caller.
+* Purpose: Copy the next line into `line` (PARSE_LINE_MAX bytes), without
+* its newline and trailing carriage returns, so the caller may cut it into
+* tokens in place while the file stays mapped read-only.
+* Returns: 1 for a line, 0 at end of input, -1 on error (rd->err tells
+* which: read failure or a line of PARSE_LINE_MAX bytes or more).
+* Notes: Memory stays bounded by the file (mapped, shared with the page
+* cache) or by the fixed streaming buffer; nothing is allocated per line.
 */
@@ -0,0 +1,148 @@
+#include <fcntl.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "../../libraries/libft/libft.h"
+#include "../../include/parser_internal_bonus.h"
+#include "../../include/rtb_bonus.h"
+#include "../../include/hash.h"
+
+static ssize_t	read_full(int fd, unsigned char *buf, size_t size)
+{
+	size_t	got;
+	ssize_t	n;
+
+	got = 0;
+	while (got < size)
+	{
+		n = read(fd, buf + got, size - got);
+		if (n < 0)
+			return (-1);
+		if (n == 0)
+			break ;
+		got += (size_t)n;
+	}
+	return ((ssize_t)got);
+}
+
+int	rtb_source_key(const char *path, t_rtb_key *key)
+{
+	struct stat		st;
+	unsigned char	*buf;
+	ssize_t			n;
+	int				fd;
+
+	fd = open(path, O_RDONLY);
+	if (fd < 0)
+		return (-1);
+	buf = (unsigned char *)malloc(RTB_HASH_CHUNK);
+	n = -1;
+	if (buf && fstat(fd, &st) == 0 && S_ISREG(st.st_mode))
+	{
+		ft_bzero(key, sizeof(*key));
+		key->size = (uint64_t)st.st_size;
+		key->mtime = (int64_t)st.st_mtime;
+		key->hash = HASH_SEED;
+		n = read_full(fd, buf, RTB_HASH_CHUNK);
+		while (n > 0)
+		{
+			key->hash = hash_words(key->hash, buf, (size_t)n);
+			n = read_full(fd, buf, RTB_HASH_CHUNK);
+		}
+	}
+	free(buf);
+	close(fd);
+	return ((int)n);
+}
+/*
+* Purpose: Identify the text a cache was built from.
+* Notes: The hash catches edits that keep the size and land within the
+* same second of mtime. The file is streamed through a small buffer:
+* every block but the last is full, so the hash never depends on how
+* read() happened to split the file.
+*/
+
+t_material	**rtb_material_slot(t_object *o)
+{
+	if (o->type == OBJ_SPHERE)
+		return (&o->u_obj.sp.material);
+	if (o->type == OBJ_PLANE)
+		return (&o->u_obj.pl.material);
+	if (o->type == OBJ_CYLINDER)
+		return (&o->u_obj.cy.material);
+	if (o->type == OBJ_TRIANGLE)
+		return (&o->u_obj.tr.material);
+	if (o->type == OBJ_HPARABOLOID)
+		return (&o->u_obj.hp.material);
+	return (NULL);
+}
+
+struct s_bumpmap	**rtb_bump_slot(t_object *o)
+{
+	if (o->type == OBJ_SPHERE)
+		return (&o->u_obj.sp.bump);
+	if (o->type == OBJ_PLANE)
+		return (&o->u_obj.pl.bump);
+	if (o->type == OBJ_CYLINDER)
+		return (&o->u_obj.cy.bump);
+	if (o->type == OBJ_TRIANGLE)
+		return (&o->u_obj.tr.bump);
+	if (o->type == OBJ_HPARABOLOID)
+		return (&o->u_obj.hp.bump);
+	return (NULL);
+}
+
+uint64_t	rtb_objects_offset(const t_rtb_header *h)
+{
+	uint64_t	end;
+
+	end = sizeof(t_rtb_header) + (uint64_t)h->light_count * sizeof(t_light);
+	return ((end + RTB_ALIGN - 1) / RTB_ALIGN * RTB_ALIGN);
+}
+/*
+* Purpose: Where the object section starts: past the lights, rounded up to
+* RTB_ALIGN so the records can be used in place from a mapping of the
+* file (the materials after them then fall on their alignment too).
+*/
+
+static char	*cache_path(const char *path)
+{
+	size_t	len;
+	char	*out;
+
+	len = ft_strlen(path);
+	if (len < 3 || ft_strncmp(path + len - 3, ".rt", 4) != 0)
+		return (NULL);
+	out = (char *)malloc(len + 2);
+	if (!out)
+		return (NULL);
+	ft_memcpy(out, path, len);
+	out[len] = 'b';
+	out[len + 1] = '\0';
+	return (out);
+}
+
+t_parse_result	scene_load(const char *path, t_scene *out)
+{
+	t_parse_result	pr;
+	t_rtb_key		key;
+	char			*rtb;
+	int				keyed;
+
+	rtb = cache_path(path);
+	keyed = (rtb && rtb_source_key(path, &key) == 0);
+	scene_init(out);
+	if (keyed && rtb_load(rtb, &key, out) == 0)
+		return (free(rtb), parse_ok());
+	pr = parse_scene(path, out);
+	if (pr.ok && keyed)
+		rtb_save(rtb, &key, out);
+	free(rtb);
+	return (pr);
+}
+/*
+* Purpose: Load a scene, from its .rtb cache when that still matches the
+* .rt, otherwise by parsing the text and then (re)writing the cache.
+* Notes: The cache is best effort: a missing, stale or foreign .rtb is
+* ignored and a failed write (read-only directory, mesh scene) is silent.
+*/
@@ -0,0 +1,189 @@
+#include <fcntl.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "../../libraries/libft/libft.h"
+#include "../../include/rtb_bonus.h"
+#include "../../include/bump_bonus.h"
+
+/*
+* A cache being loaded: its header, and where the materials and the
+* bump paths sit in the mapping (right after the objects).
+*/
+typedef struct s_rtb_view
+{
+	t_rtb_header	h;
+	t_material		*materials;
+	const char		*strings;
+}	t_rtb_view;
+
+static int	check_header(const t_rtb_header *h, const t_rtb_key *key,
+		uint64_t file_size)
+{
+	uint64_t	need;
+
+	if (h->magic != RTB_MAGIC || h->version != RTB_VERSION
+		|| h->object_size != sizeof(t_object)
+		|| h->light_size != sizeof(t_light)
+		|| h->material_size != sizeof(t_material))
+		return (-1);
+	if (h->key.size != key->size || h->key.mtime != key->mtime
+		|| h->key.hash != key->hash)
+		return (-1);
+	need = rtb_objects_offset(h)
+		+ (uint64_t)h->object_count * sizeof(t_object)
+		+ (uint64_t)h->material_count * sizeof(t_material)
+		+ h->string_bytes;
+	if (need != file_size || h->light_count == 0 || h->light_count > 65536)
+		return (-1);
+	return (0);
+}
+/*
+* Purpose: Accept only a cache of this build's layout, made from exactly
+* this source, whose sections add up to the file size.
+*/
+
+static int	map_file(int fd, t_scene *scene)
+{
+	struct stat	st;
+	void		*map;
+
+	if (fstat(fd, &st) < 0 || st.st_size < (off_t)sizeof(t_rtb_header))
+		return (-1);
+	map = mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE,
+			MAP_PRIVATE, fd, 0);
+	if (map == MAP_FAILED)
+		return (-1);
+	scene->block = map;
+	scene->block_size = (size_t)st.st_size;
+	return (0);
+}
+/*
+* Purpose: Map the whole cache as the scene block.
+* Notes: The mapping is private and writable: loading rewrites the stored
+* indices into pointers, and the editor moves objects in place, all
+* without touching the file.
+*/
+
+static int	link_objects(const t_rtb_view *v, t_object *obj)
+{
+	uint32_t	i;
+	uintptr_t	idx;
+	t_material	**slot;
+
+	i = 0;
+	while (i < v->h.object_count)
+	{
+		obj[i].next = NULL;
+		if (i + 1 < v->h.object_count)
+			obj[i].next = &obj[i + 1];
+		slot = rtb_material_slot(&obj[i]);
+		if (!slot)
+			return (-1);
+		idx = (uintptr_t)*slot;
+		if (idx > v->h.material_count)
+			return (-1);
+		*slot = NULL;
+		if (idx)
+			*slot = &v->materials[idx - 1];
+		i++;
+	}
+	return (0);
+}
+/*
+* Purpose: Chain the object records in file order and point each one at
+* its material, checking every type and index against the sections.
+*/
+
+static int	acquire_bumps(const t_rtb_view *v, t_object *obj, t_scene *scene)
+{
+	uint32_t			i;
+	uintptr_t			off;
+	struct s_bumpmap	**slot;
+	int					failed;
+
+	failed = (v->h.string_bytes > 0
+			&& v->strings[v->h.string_bytes - 1] != '\0');
+	i = 0;
+	while (i < v->h.object_count)
+	{
+		slot = rtb_bump_slot(&obj[i++]);
+		off = (uintptr_t)*slot;
+		*slot = NULL;
+		if (off && !failed && off <= v->h.string_bytes)
+			*slot = bump_acquire(&scene->bumps, v->strings + off - 1);
+		if (off && !*slot)
+			failed = 1;
+	}
+	return (-failed);
+}
+/*
+* Purpose: Load (or share, through the scene cache) the bump maps named in
+* the string table.
+* Notes: After a failure the remaining slots are cleared, so scene_free
+* releases exactly the maps that were acquired.
+*/
+
+static int	fill_scene(t_rtb_view *v, t_scene *scene)
+{
+	t_object	*obj;
+	size_t		lights;
+
+	lights = sizeof(t_light) * v->h.light_count;
+	scene->lights = (t_light *)malloc(lights);
+	if (!scene->lights)
+		return (-1);
+	ft_memcpy(scene->lights, (char *)scene->block + sizeof(t_rtb_header),
+		lights);
+	scene->light_count = (int)v->h.light_count;
+	scene->light_cap = scene->light_count;
+	obj = (t_object *)((char *)scene->block + rtb_objects_offset(&v->h));
+	v->materials = (t_material *)(obj + v->h.object_count);
+	v->strings = (const char *)(v->materials + v->h.material_count);
+	if (link_objects(v, obj) < 0)
+		return (-1);
+	if (v->h.object_count)
+		scene->objects = obj;
+	scene->ambient = v->h.ambient;
+	scene->camera = v->h.camera;
+	return (acquire_bumps(v, obj, scene));
+}
+/*
+* Purpose: Use the mapped sections in place: objects, materials and bump
+* paths stay in the mapping and only their stored indices become
+* pointers. The lights are copied out, since adding one may grow their
+* array.
+*/
+
+int	rtb_load(const char *rtb_path, const t_rtb_key *key, t_scene *scene)
+{
+	t_rtb_view	v;
+	int			fd;
+	int			rc;
+
+	fd = open(rtb_path, O_RDONLY);
+	if (fd < 0)
+		return (-1);
+	rc = map_file(fd, scene);
+	close(fd);
+	if (rc == 0)
+	{
+		v.h = *(const t_rtb_header *)scene->block;
+		rc = check_header(&v.h, key, (uint64_t)scene->block_size);
+	}
+	if (rc == 0)
+		rc = fill_scene(&v, scene);
+	if (rc < 0)
+	{
+		scene_free(scene);
+		scene_init(scene);
+	}
+	return (rc);
+}
+/*
+* Purpose: Rebuild a parsed scene from its cache without parsing: map it,
+* check the header, then fix up the records where they lie.
+* Returns: 0 on a hit; -1 (scene left empty) when the cache is missing,
+* stale, written by another layout, or damaged.
+*/
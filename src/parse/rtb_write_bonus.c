@@ -0,0 +1,199 @@
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "../../libraries/libft/libft.h"
+#include "../../include/rtb_bonus.h"
+#include "../../include/bump_bonus.h"
+
+/* Buffered output of a cache file; err sticks after the first failure. */
+typedef struct s_rtb_out
+{
+	int				fd;
+	int				err;
+	size_t			len;
+	unsigned char	buf[65536];
+}	t_rtb_out;
+
+static void	out_flush(t_rtb_out *out)
+{
+	size_t	done;
+	ssize_t	n;
+
+	done = 0;
+	while (!out->err && done < out->len)
+	{
+		n = write(out->fd, out->buf + done, out->len - done);
+		if (n <= 0)
+			out->err = 1;
+		else
+			done += (size_t)n;
+	}
+	out->len = 0;
+}
+
+static void	out_put(t_rtb_out *out, const void *data, size_t size)
+{
+	size_t	n;
+
+	while (size > 0 && !out->err)
+	{
+		if (out->len == sizeof(out->buf))
+			out_flush(out);
+		n = sizeof(out->buf) - out->len;
+		if (n > size)
+			n = size;
+		ft_memcpy(out->buf + out->len, data, n);
+		out->len += n;
+		data = (const unsigned char *)data + n;
+		size -= n;
+	}
+}
+
+static void	out_pad(t_rtb_out *out, size_t size)
+{
+	unsigned char	zero[RTB_ALIGN];
+
+	ft_bzero(zero, sizeof(zero));
+	out_put(out, zero, size);
+}
+/*
+* Purpose: Write `size` (< RTB_ALIGN) zero bytes of section padding.
+*/
+
+static uintptr_t	bump_offset(const t_scene *scene, const t_bumpmap *bm)
+{
+	const t_bumpmap	*it;
+	uintptr_t		off;
+
+	off = 1;
+	it = scene->bumps;
+	while (it && it != bm)
+	{
+		off += ft_strlen(it->path) + 1;
+		it = it->next;
+	}
+	return (off);
+}
+/*
+* Purpose: 1-based offset of `bm`'s path in the string table, which lists
+* the paths of the scene's bump cache in order.
+*/
+
+static int	fill_header(t_rtb_header *h, const t_rtb_key *key,
+		const t_scene *scene)
+{
+	const t_object	*o;
+	const t_bumpmap	*bm;
+
+	ft_bzero(h, sizeof(*h));
+	h->magic = RTB_MAGIC;
+	h->version = RTB_VERSION;
+	h->object_size = sizeof(t_object);
+	h->light_size = sizeof(t_light);
+	h->material_size = sizeof(t_material);
+	h->light_count = (uint32_t)scene->light_count;
+	h->key = *key;
+	h->ambient = scene->ambient;
+	h->camera = scene->camera;
+	o = scene->objects;
+	while (o)
+	{
+		if (o->type == OBJ_MESH)
+			return (-1);
+		h->object_count++;
+		if (*rtb_material_slot((t_object *)o))
+			h->material_count++;
+		o = o->next;
+	}
+	bm = scene->bumps;
+	while (bm)
+	{
+		h->string_bytes += ft_strlen(bm->path) + 1;
+		bm = bm->next;
+	}
+	return (0);
+}
+/*
+* Purpose: Count the sections; a scene with an OBJ mesh is not cached.
+*/
+
+static void	put_objects(t_rtb_out *out, const t_scene *scene)
+{
+	const t_object	*o;
+	t_object		rec;
+	uintptr_t		mat;
+
+	mat = 0;
+	o = scene->objects;
+	while (o)
+	{
+		rec = *o;
+		rec.next = NULL;
+		if (*rtb_material_slot(&rec))
+			*rtb_material_slot(&rec) = (t_material *)++mat;
+		if (*rtb_bump_slot(&rec))
+			*rtb_bump_slot(&rec) = (struct s_bumpmap *)bump_offset(scene,
+					*rtb_bump_slot(&rec));
+		out_put(out, &rec, sizeof(rec));
+		o = o->next;
+	}
+	o = scene->objects;
+	while (o)
+	{
+		if (*rtb_material_slot((t_object *)o))
+			out_put(out, *rtb_material_slot((t_object *)o),
+				sizeof(t_material));
+		o = o->next;
+	}
+}
+/*
+* Purpose: Write the object records, pointers swapped for indices, then
+* the materials they refer to, in the same order.
+*/
+
+int	rtb_save(const char *rtb_path, const t_rtb_key *key, const t_scene *scene)
+{
+	t_rtb_out		*out;
+	t_rtb_header	h;
+	const t_bumpmap	*bm;
+	char			*tmp;
+	int				err;
+
+	if (fill_header(&h, key, scene) < 0)
+		return (-1);
+	out = (t_rtb_out *)malloc(sizeof(t_rtb_out));
+	tmp = ft_strjoin(rtb_path, ".tmp");
+	if (out && tmp)
+		out->fd = open(tmp, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (!out || !tmp || out->fd < 0)
+		return (free(out), free(tmp), -1);
+	out->err = 0;
+	out->len = 0;
+	out_put(out, &h, sizeof(h));
+	out_put(out, scene->lights, sizeof(t_light) * (size_t)scene->light_count);
+	out_pad(out, (size_t)(rtb_objects_offset(&h) - sizeof(h))
+		- sizeof(t_light) * (size_t)scene->light_count);
+	put_objects(out, scene);
+	bm = scene->bumps;
+	while (bm)
+	{
+		out_put(out, bm->path, ft_strlen(bm->path) + 1);
+		bm = bm->next;
+	}
+	out_flush(out);
+	err = out->err;
+	if (close(out->fd) < 0 || err || rename(tmp, rtb_path) < 0)
+	{
+		unlink(tmp);
+		err = 1;
+	}
+	free(out);
+	free(tmp);
+	return (-err);
+}
+/*
+* Purpose: Write the cache of a freshly parsed scene.
+* Notes: The file is completed under a temporary name and renamed over the
+* old cache, so a reader never maps a half-written one.
+*/
@@ -1,66 +1,37 @@
-#include <stdlib.h>
-#include "../../libraries/libft/libft.h"
 #include "../../include/parser_internal.h"
 
-static char	*dup_with_spaces(const char *src)
+static int	is_ws(char c)
 {
-	size_t	len;
-	char	*dst;
-	size_t	index;
-
-	len = ft_strlen(src);
-	dst = (char *)malloc(len + 1);
-	if (!dst)
-		return (NULL);
-	index = 0;
-	while (index < len)
-	{
-		if (src[index] == '\t')
-			dst[index] = ' ';
-		else
-			dst[index] = src[index];
-		index++;
-	}
-	dst[index] = '\0';
-	return (dst);
+	return (c == ' ' || c == '\t');
 }
-/*
-* Purpose: Duplicate a string while normalizing tabs into spaces for splitting.
-* Notes: Keeps other characters intact; caller must free the returned copy.
-*/
-
-char	**split_ws(const char *s)
-{
-	char	*norm;
-	char	**tokens;
-
-	norm = dup_with_spaces(s);
-	if (!norm)
-		return (NULL);
-	tokens = ft_split(norm, ' ');
-	free(norm);
-	return (tokens);
-}
-/*
-* Purpose: Produce a NULL-terminated token array split on spaces.
-* Handling: Converts tabs to spaces first to align with subject formatting.
-*/
 
-void	free_tokens(char **toks)
+int	split_ws(char *line, char **tokens, int max)
 {
-	size_t	index;
+	int	count;
 
-	if (!toks)
-		return ;
-	index = 0;
-	while (toks[index])
+	count = 0;
+	while (*line)
 	{
-		free(toks[index]);
-		index++;
+		while (is_ws(*line))
+			*line++ = '\0';
+		if (!*line)
+			break ;
+		if (count == max)
+			return (-1);
+		tokens[count++] = line;
+		while (*line && !is_ws(*line))
+			line++;
 	}
-	free(toks);
+	max = count;
+	while (max <= PARSE_MAX_TOKENS)
+		tokens[max++] = NULL;
+	return (count);
 }
 /*
-* Purpose: Release the token array created by `split_ws`.
-* Behavior: Frees each string element and the container pointer.
+* Purpose: Split a line on spaces and tabs in place: separators become
+* '\0' and `tokens` points at each field, so no token is copied.
+* Inputs: `tokens` has room for PARSE_MAX_TOKENS + 1 entries, `max` is at
+* most PARSE_MAX_TOKENS.
+* Returns: Number of tokens (0 for a blank line), the unused entries all
+* NULL; -1 when the line has more than `max` fields.
 */
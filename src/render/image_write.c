@@ -0,0 +1,127 @@
+#include <fcntl.h>
+#include "../../include/minirt.h"
+#include "../../include/image_write.h"
+
+void	outbuf_flush(t_outbuf *o)
+{
+	size_t	off;
+	ssize_t	n;
+
+	off = 0;
+	while (!o->err && off < o->len)
+	{
+		n = write(o->fd, o->data + off, o->len - off);
+		if (n <= 0)
+			o->err = 1;
+		else
+			off += (size_t)n;
+	}
+	o->len = 0;
+}
+
+void	outbuf_put(t_outbuf *o, const void *src, size_t n)
+{
+	const uint8_t	*p;
+	size_t			chunk;
+
+	p = (const uint8_t *)src;
+	while (n > 0)
+	{
+		if (o->len == OUTBUF_SIZE)
+			outbuf_flush(o);
+		chunk = OUTBUF_SIZE - o->len;
+		if (chunk > n)
+			chunk = n;
+		ft_memcpy(o->data + o->len, p, chunk);
+		o->len += chunk;
+		p += chunk;
+		n -= chunk;
+	}
+}
+
+static void	put_uint(t_outbuf *o, unsigned int v, char sep)
+{
+	char	tmp[12];
+	int		i;
+
+	i = 11;
+	tmp[i] = sep;
+	tmp[--i] = (char)('0' + v % 10);
+	while (v >= 10)
+	{
+		v /= 10;
+		tmp[--i] = (char)('0' + v % 10);
+	}
+	outbuf_put(o, tmp + i, (size_t)(12 - i));
+}
+
+void	image_write_ppm(t_outbuf *o, const uint32_t *fb, int w, int h)
+{
+	uint8_t	rgb[3];
+	size_t	i;
+	size_t	count;
+
+	outbuf_put(o, "P6\n", 3);
+	put_uint(o, (unsigned int)w, ' ');
+	put_uint(o, (unsigned int)h, '\n');
+	outbuf_put(o, "255\n", 4);
+	count = (size_t)w * (size_t)h;
+	i = 0;
+	while (i < count)
+	{
+		rgb[0] = (uint8_t)(fb[i] >> 24);
+		rgb[1] = (uint8_t)(fb[i] >> 16);
+		rgb[2] = (uint8_t)(fb[i] >> 8);
+		outbuf_put(o, rgb, 3);
+		i++;
+	}
+}
+/*
+* Purpose: Binary PPM (P6): a tiny text header followed by raw RGB bytes.
+*/
+
+t_img_format	image_format(const char *path)
+{
+	const char	*ext;
+
+	ext = ft_strrchr(path, '.');
+	if (!ext)
+		return (IMG_UNKNOWN);
+	if (ft_strcmp(ext, ".ppm") == 0 || ft_strcmp(ext, ".PPM") == 0)
+		return (IMG_PPM);
+	if (ft_strcmp(ext, ".png") == 0 || ft_strcmp(ext, ".PNG") == 0)
+		return (IMG_PNG);
+	return (IMG_UNKNOWN);
+}
+
+int	image_write(const char *path, const uint32_t *fb, int w, int h)
+{
+	t_outbuf		*o;
+	t_img_format	fmt;
+	int				ok;
+
+	fmt = image_format(path);
+	o = (t_outbuf *)malloc(sizeof(t_outbuf));
+	if (fmt == IMG_UNKNOWN || !o)
+		return (free(o), -1);
+	o->fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	o->err = (o->fd < 0);
+	o->len = 0;
+	ok = 0;
+	if (!o->err && fmt == IMG_PNG)
+		ok = image_write_png(o, fb, w, h);
+	else if (!o->err)
+		image_write_ppm(o, fb, w, h);
+	outbuf_flush(o);
+	if (o->fd >= 0 && close(o->fd) < 0)
+		o->err = 1;
+	ok = (ok == 0 && !o->err);
+	free(o);
+	if (!ok)
+		return (-1);
+	return (0);
+}
+/*
+* Purpose: Save the framebuffer to `path` in the format named by its
+* extension.
+*/
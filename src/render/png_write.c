@@ -0,0 +1,207 @@
+#include "../../include/minirt.h"
+#include "../../include/image_write.h"
+
+#define STORED_MAX 65535u
+#define ADLER_MOD 65521u
+
+/*
+* PNG writer state. `crc` runs over the current chunk (type + data); the
+* zlib stream inside IDAT is made of stored (uncompressed) deflate blocks,
+* `block_left` bytes remaining in the open block and `raw_left` in total.
+*/
+typedef struct s_png
+{
+	t_outbuf	*o;
+	uint32_t	table[256];
+	uint32_t	crc;
+	uint32_t	adler_a;
+	uint32_t	adler_b;
+	uint32_t	block_left;
+	uint32_t	raw_left;
+}	t_png;
+
+static void	png_bytes(t_png *png, const uint8_t *p, size_t n)
+{
+	size_t	i;
+
+	outbuf_put(png->o, p, n);
+	i = 0;
+	while (i < n)
+	{
+		png->crc = png->table[(png->crc ^ p[i]) & 0xFFu] ^ (png->crc >> 8);
+		i++;
+	}
+}
+
+static void	put_be32(uint8_t *dst, uint32_t v)
+{
+	dst[0] = (uint8_t)(v >> 24);
+	dst[1] = (uint8_t)(v >> 16);
+	dst[2] = (uint8_t)(v >> 8);
+	dst[3] = (uint8_t)v;
+}
+
+static void	chunk_begin(t_png *png, uint32_t len, const char *type)
+{
+	uint8_t	be[4];
+
+	put_be32(be, len);
+	outbuf_put(png->o, be, 4);
+	png->crc = 0xFFFFFFFFu;
+	png_bytes(png, (const uint8_t *)type, 4);
+}
+
+static void	chunk_end(t_png *png)
+{
+	uint8_t	be[4];
+
+	put_be32(be, png->crc ^ 0xFFFFFFFFu);
+	outbuf_put(png->o, be, 4);
+}
+
+static void	init_crc_table(uint32_t *table)
+{
+	uint32_t	c;
+	int			n;
+	int			k;
+
+	n = 0;
+	while (n < 256)
+	{
+		c = (uint32_t)n;
+		k = 0;
+		while (k++ < 8)
+		{
+			if (c & 1u)
+				c = 0xEDB88320u ^ (c >> 1);
+			else
+				c >>= 1;
+		}
+		table[n++] = c;
+	}
+}
+
+static void	zlib_raw(t_png *png, const uint8_t *p, uint32_t n)
+{
+	uint8_t		hdr[5];
+	uint32_t	take;
+	uint32_t	i;
+
+	while (n > 0)
+	{
+		if (png->block_left == 0)
+		{
+			png->block_left = png->raw_left;
+			if (png->block_left > STORED_MAX)
+				png->block_left = STORED_MAX;
+			hdr[0] = (png->block_left == png->raw_left);
+			hdr[1] = (uint8_t)png->block_left;
+			hdr[2] = (uint8_t)(png->block_left >> 8);
+			hdr[3] = (uint8_t)~hdr[1];
+			hdr[4] = (uint8_t)~hdr[2];
+			png_bytes(png, hdr, 5);
+		}
+		take = n;
+		if (take > png->block_left)
+			take = png->block_left;
+		png_bytes(png, p, take);
+		i = 0;
+		while (i < take)
+		{
+			png->adler_a = (png->adler_a + p[i++]) % ADLER_MOD;
+			png->adler_b = (png->adler_b + png->adler_a) % ADLER_MOD;
+		}
+		png->block_left -= take;
+		png->raw_left -= take;
+		p += take;
+		n -= take;
+	}
+}
+/*
+* Purpose: Append `n` bytes of scanline data to the zlib stream, opening a
+* new stored block (BFINAL on the last one) every 65535 bytes.
+*/
+
+static void	write_rows(t_png *png, const uint32_t *fb, int w, int h,
+		uint8_t *row)
+{
+	int	x;
+	int	y;
+
+	y = 0;
+	while (y < h)
+	{
+		row[0] = 0;
+		x = 0;
+		while (x < w)
+		{
+			row[1 + x * 3] = (uint8_t)(fb[(size_t)y * w + x] >> 24);
+			row[2 + x * 3] = (uint8_t)(fb[(size_t)y * w + x] >> 16);
+			row[3 + x * 3] = (uint8_t)(fb[(size_t)y * w + x] >> 8);
+			x++;
+		}
+		zlib_raw(png, row, 1u + 3u * (uint32_t)w);
+		y++;
+	}
+}
+
+static void	write_idat(t_png *png, const uint32_t *fb, int w, int h,
+		uint8_t *row)
+{
+	uint8_t		buf[4];
+	uint32_t	blocks;
+
+	png->raw_left = (uint32_t)h * (1u + 3u * (uint32_t)w);
+	blocks = (png->raw_left + STORED_MAX - 1) / STORED_MAX;
+	chunk_begin(png, 2 + png->raw_left + 5 * blocks + 4, "IDAT");
+	buf[0] = 0x78;
+	buf[1] = 0x01;
+	png_bytes(png, buf, 2);
+	png->adler_a = 1;
+	png->adler_b = 0;
+	png->block_left = 0;
+	write_rows(png, fb, w, h, row);
+	put_be32(buf, (png->adler_b << 16) | png->adler_a);
+	png_bytes(png, buf, 4);
+	chunk_end(png);
+}
+/*
+* Purpose: Single IDAT chunk holding the whole zlib stream: header (no
+* compression, no dictionary), stored blocks, then the Adler-32 trailer.
+*/
+
+int	image_write_png(t_outbuf *o, const uint32_t *fb, int w, int h)
+{
+	static const uint8_t	sig[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A,
+		'\n'};
+	t_png					png;
+	uint8_t					ihdr[13];
+	uint8_t					*row;
+
+	row = (uint8_t *)malloc(1 + 3 * (size_t)w);
+	if (!row)
+		return (-1);
+	png.o = o;
+	init_crc_table(png.table);
+	outbuf_put(o, sig, 8);
+	put_be32(ihdr, (uint32_t)w);
+	put_be32(ihdr + 4, (uint32_t)h);
+	ihdr[8] = 8;
+	ihdr[9] = 2;
+	ihdr[10] = 0;
+	ihdr[11] = 0;
+	ihdr[12] = 0;
+	chunk_begin(&png, 13, "IHDR");
+	png_bytes(&png, ihdr, 13);
+	chunk_end(&png);
+	write_idat(&png, fb, w, h, row);
+	chunk_begin(&png, 0, "IEND");
+	chunk_end(&png);
+	free(row);
+	return (0);
+}
+/*
+* Purpose: 8-bit RGB PNG of the framebuffer (alpha is always opaque).
+* Notes: Pixels are stored, not deflated, so files are about the size of a
+* PPM; any PNG reader accepts them and no zlib dependency is needed.
+*/
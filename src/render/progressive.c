@@ -0,0 +1,179 @@
+#include <time.h>
+#include "../../include/render.h"
+#include "../../include/app.h"
+#include "../../include/workers.h"
+#include "../../include/ray_stats.h"
+
+static long long	now_ns(void)
+{
+	struct timespec	ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ((long long)ts.tv_sec * 1000000000LL + ts.tv_nsec);
+}
+
+static void	fill_block(t_app *app, int x, int y, int step)
+{
+	const t_gbuf_px	*src;
+	uint32_t		c;
+	int				bx;
+	int				by;
+
+	c = app->framebuffer[y * app->width + x];
+	src = NULL;
+	if (app->gbuf)
+		src = &app->gbuf[y * app->width + x];
+	by = y;
+	while (by < y + step && by < app->height)
+	{
+		bx = x;
+		while (bx < x + step && bx < app->width)
+		{
+			app->framebuffer[by * app->width + bx] = c;
+			if (src)
+				app->gbuf[by * app->width + bx] = *src;
+			bx++;
+		}
+		by++;
+	}
+}
+/*
+* Purpose: Stretch the sample at (x, y) over its step x step block, in the
+* framebuffer and in the G-buffer, so re-shading a half-refined frame shows
+* the same blocks as the screen.
+*/
+
+static void	flush_run(t_prog_job *job, t_pixel_run *run)
+{
+	int	i;
+
+	if (run->count == 0)
+		return ;
+	render_run(job->app, &job->frame, run);
+	i = 0;
+	while (job->step > 1 && i < run->count)
+		fill_block(job->app, run->x[i++], run->y, job->step);
+	run->count = 0;
+}
+
+static void	render_tile_step(t_prog_job *job, int tile)
+{
+	t_pixel_run	run;
+	int			x0;
+	int			x;
+	int			s;
+
+	s = job->step;
+	x0 = (tile % job->tiles_x) * TILE_SIZE;
+	run.y = (tile / job->tiles_x) * TILE_SIZE;
+	run.count = 0;
+	while (run.y < (tile / job->tiles_x + 1) * TILE_SIZE
+		&& run.y < job->app->height)
+	{
+		x = x0;
+		while (x < x0 + TILE_SIZE && x < job->app->width)
+		{
+			if (s == PROGRESS_START || x % (s * 2) || run.y % (s * 2))
+				run.x[run.count++] = x;
+			if (run.count == PACKET_W)
+				flush_run(job, &run);
+			x += s;
+		}
+		flush_run(job, &run);
+		run.y += s;
+	}
+}
+/*
+* Purpose: Trace the pixels of `tile` that lie on the current step's grid,
+* grouped per row into packets.
+* Logic: Samples are real pixel centres (x, y multiples of step), so every
+* traced value is final. Pixels on the previous, twice coarser grid were
+* already traced and are skipped: over all passes each pixel is traced
+* exactly once.
+*/
+
+static void	*progress_worker(void *ctx)
+{
+	t_prog_job	*job;
+	int			tile;
+
+	job = (t_prog_job *)ctx;
+	while (now_ns() < job->deadline)
+	{
+		tile = atomic_fetch_add(&job->next, 1);
+		if (tile >= job->tile_count)
+			break ;
+		render_tile_step(job, tile);
+	}
+	ray_stats_flush_thread();
+	return (NULL);
+}
+
+void	render_invalidate(t_app *app)
+{
+	app->progress.step = PROGRESS_START;
+	app->progress.next_tile = 0;
+}
+/*
+* Purpose: Drop whatever refinement is in flight and restart from the
+* coarse pass on the next frame. Call after any change that moves geometry,
+* the camera or the light position.
+*/
+
+void	render_moved(t_app *app)
+{
+	render_invalidate(app);
+	app->progress.moved_ns = now_ns();
+}
+/*
+* Purpose: Restart refinement after an interactive edit and keep it at the
+* coarse pass while edits keep arriving (see render_progress_frame).
+*/
+
+static bool	input_settled(const t_app *app)
+{
+	return (app->progress.moved_ns == 0 || now_ns() - app->progress.moved_ns
+		>= PROGRESS_SETTLE_MS * 1000000LL);
+}
+
+void	render_progress_frame(void *param)
+{
+	t_app		*app;
+	t_prog_job	job;
+
+	app = (t_app *)param;
+	if (app->progress.step < 1)
+		return ;
+	job.tiles_x = (app->width + TILE_SIZE - 1) / TILE_SIZE;
+	job.tile_count = job.tiles_x * ((app->height + TILE_SIZE - 1) / TILE_SIZE);
+	if (app->progress.next_tile >= job.tile_count)
+	{
+		if (!input_settled(app))
+			return ;
+		app->progress.step /= 2;
+		app->progress.next_tile = 0;
+		if (app->progress.step < 1)
+			return ;
+	}
+	job.app = app;
+	job.step = app->progress.step;
+	camera_build_frame(&app->scene.camera, app->width, app->height,
+		&job.frame);
+	job.deadline = now_ns() + PROGRESS_BUDGET_MS * 1000000LL;
+	atomic_init(&job.next, app->progress.next_tile);
+	workers_run(app->threads, progress_worker, &job);
+	app->progress.next_tile = atomic_load(&job.next);
+	if (app->progress.next_tile > job.tile_count)
+		app->progress.next_tile = job.tile_count;
+	upload_framebuffer(app->image, app->framebuffer);
+}
+/*
+* Purpose: mlx_loop_hook callback: advance the progressive render by about
+* PROGRESS_BUDGET_MS of work, then present what is there.
+* Logic: Passes go step 4 (1/16 of the pixels), 2, then 1 (full
+* resolution). Workers stop claiming tiles once the frame budget is spent
+* and the next frame resumes at the first unclaimed tile, so the window
+* keeps handling input however heavy the scene is. A finished pass only
+* gives way to the next, finer one once input has settled, so dragging an
+* object around re-renders at 1/16 resolution only. Step 0 means done.
+*/
@@ -1,42 +1,72 @@
-#include <float.h>
 #include "../../include/render.h"
 #include "../../include/camera.h"
 #include "../../include/app.h"
 #include "../../include/shading.h"
 
-static t_vec3	trace_pixel(const t_scene *scene, t_ray r, int show_normals)
+static void	store_hit(const t_scene *scene, const t_hit *hit, t_gbuf_px *px)
 {
-	t_hit	hit;
+	px->hit = hit->ok;
+	if (!px->hit)
+		return ;
+	px->p = hit->p;
+	px->n = hit->n;
+	px->albedo = hit->albedo;
+	px->ks = 0.0f;
+	px->shininess = 0.0f;
+	px->lit = 0;
+	if (in_shadow(scene, hit->p, scene->lights[0].pos))
+		return ;
+	px->light[0] = 0;
+	px->weight[0] = 1.0f;
+	px->lit = 1;
+}
+/*
+* Purpose: Keep a primary hit in its G-buffer texel, tracing the shadow
+* ray on the way; shade_pixel turns the texel into a colour.
+*/
 
-	scene_hit(scene, r, FLT_MAX, &hit);
-	if (show_normals && hit.ok)
-		return (v3_mul(v3_add(hit.n, v3(1.0f, 1.0f, 1.0f)), 0.5f));
-	return (shade_lambert(scene, &hit));
+uint32_t	shade_pixel(const t_app *app, const t_gbuf_px *px)
+{
+	if (!px->hit)
+		return (vec3_to_rgba(v3(0.0f, 0.0f, 0.0f)));
+	if (app->show_normals)
+		return (vec3_to_rgba(v3_mul(v3_add(px->n, v3(1.0f, 1.0f, 1.0f)),
+					0.5f)));
+	return (vec3_to_rgba(shade_lambert(&app->scene, px)));
 }
 
-void	render_scene(t_app *app)
+void	render_run(const t_app *app, const t_cam_frame *frame,
+		const t_pixel_run *run)
 {
-	int				x;
-	int				y;
-	t_render_aux	vars;
+	t_ray		rays[PACKET_W];
+	t_hit		hits[PACKET_W];
+	t_gbuf_px	local;
+	t_gbuf_px	*px;
+	int			i;
 
-	camera_build_frame(&app->scene.camera, app->image->width,
-		app->image->height, &vars.frame);
-	y = -1;
-	while ((uint32_t)++y < app->image->height)
+	i = -1;
+	while (++i < run->count)
+		rays[i] = camera_ray(frame, ((float)run->x[i] + 0.5f)
+				/ (float)app->width, 1.0f - (((float)run->y + 0.5f)
+					/ (float)app->height));
+	scene_hit_packet(&app->scene, rays, run->count, hits);
+	i = -1;
+	while (++i < run->count)
 	{
-		x = -1;
-		while ((uint32_t)++x < app->image->width)
-		{
-			vars.u = ((float)x + 0.5f) / (float)app->image->width;
-			vars.v = 1.0f - (((float)y + 0.5f) / (float)app->image->height);
-			vars.sample = v3_add(vars.frame.lower_left,
-					v3_add(v3_mul(vars.frame.horizontal, vars.u),
-						v3_mul(vars.frame.vertical, vars.v)));
-			vars.dir = v3_norm(v3_sub(vars.sample, vars.frame.origin));
-			app->framebuffer[y * app->image->width + x]
-				= vec3_to_rgba(trace_pixel(&app->scene,
-						ray(vars.frame.origin, vars.dir), app->show_normals));
-		}
+		px = &local;
+		if (app->gbuf)
+			px = &app->gbuf[(size_t)run->y * (size_t)app->width
+				+ (size_t)run->x[i]];
+		store_hit(&app->scene, &hits[i], px);
+		app->framebuffer[(size_t)run->y * (size_t)app->width
+			+ (size_t)run->x[i]] = shade_pixel(app, px);
 	}
 }
+/*
+* Purpose: Trace and shade a run of pixels of one row, keeping their
+* G-buffer texels when the app has one.
+* Logic: The primary rays go through scene_hit_packet as one packet; shadow
+* rays and shading stay per pixel.
+* Use: Called concurrently by the tile workers; a run only writes its own
+* pixels and texels, so no synchronisation is required.
+*/
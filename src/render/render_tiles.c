@@ -0,0 +1,105 @@
+#include "../../include/render.h"
+#include "../../include/app.h"
+#include "../../include/workers.h"
+#include "../../include/ray_stats.h"
+
+static void	trace_row(t_tile_job *job, int x0, int y)
+{
+	t_pixel_run	run;
+	int			x;
+
+	run.y = y;
+	x = x0;
+	while (x < x0 + TILE_SIZE && x < job->width)
+	{
+		run.count = 0;
+		while (run.count < PACKET_W && x < x0 + TILE_SIZE && x < job->width)
+			run.x[run.count++] = x++;
+		render_run(job->app, &job->frame, &run);
+	}
+}
+/*
+* Purpose: Trace one row of a tile as runs of PACKET_W adjacent pixels.
+*/
+
+static void	render_tile(t_tile_job *job, int tile)
+{
+	int	x0;
+	int	y0;
+	int	x;
+	int	y;
+
+	x0 = (tile % job->tiles_x) * TILE_SIZE;
+	y0 = (tile / job->tiles_x) * TILE_SIZE;
+	y = y0;
+	while (y < y0 + TILE_SIZE && y < job->height)
+	{
+		x = x0;
+		while (job->reshade && x < x0 + TILE_SIZE && x < job->width)
+		{
+			job->app->framebuffer[y * job->width + x] = shade_pixel(
+					job->app, &job->app->gbuf[y * job->width + x]);
+			x++;
+		}
+		if (!job->reshade)
+			trace_row(job, x0, y);
+		y++;
+	}
+}
+
+static void	*tile_worker(void *ctx)
+{
+	t_tile_job	*job;
+	int			tile;
+
+	job = (t_tile_job *)ctx;
+	tile = atomic_fetch_add(&job->next, 1);
+	while (tile < job->tile_count)
+	{
+		render_tile(job, tile);
+		tile = atomic_fetch_add(&job->next, 1);
+	}
+	ray_stats_flush_thread();
+	return (NULL);
+}
+
+static void	run_tiles(t_app *app, int reshade)
+{
+	t_tile_job	job;
+
+	job.app = app;
+	job.reshade = reshade;
+	job.width = app->width;
+	job.height = app->height;
+	camera_build_frame(&app->scene.camera, job.width, job.height, &job.frame);
+	job.tiles_x = (job.width + TILE_SIZE - 1) / TILE_SIZE;
+	job.tile_count = job.tiles_x * ((job.height + TILE_SIZE - 1) / TILE_SIZE);
+	atomic_init(&job.next, 0);
+	workers_run(app->threads, tile_worker, &job);
+}
+
+void	render_scene(t_app *app)
+{
+	run_tiles(app, 0);
+}
+/*
+* Purpose: Render the whole frame on `app->threads` workers.
+* Logic: The screen is cut into TILE_SIZE x TILE_SIZE tiles; each worker pulls
+* the next tile index from a shared atomic counter, so fast tiles (sky) and
+* slow ones (meshes) balance themselves out.
+* Notes: Every pixel is computed the same way (render_run) regardless of
+* the thread that runs it, so the output is identical for any thread count.
+*/
+
+void	render_reshade(t_app *app)
+{
+	if (!app->gbuf)
+		return (render_scene(app));
+	run_tiles(app, 1);
+}
+/*
+* Purpose: Redraw the frame from the G-buffer filled by the last
+* render_scene, e.g. after a display-mode switch or a light/ambient change.
+* Notes: Shading a texel costs a few vector operations, so the whole frame
+* takes milliseconds; without a G-buffer this falls back to a full render.
+*/
@@ -1,6 +1,7 @@
 #include <stdlib.h>
 #include <math.h>
 #include "../../libraries/MLX42/include/MLX42/MLX42.h"
+#include "../../libraries/libft/libft.h"
 #include "../../include/bump_bonus.h"
 #include "../../include/vec3.h"
 
@@ -26,6 +27,9 @@ t_bumpmap *bump_load_png(const char *path)
         mlx_delete_texture(tex);
         return (NULL);
     }
+    bm->path = NULL;
+    bm->refs = 0;
+    bm->next = NULL;
     bm->w = (int)tex->width;
     bm->h = (int)tex->height;
     bm->hmap = (float *)malloc(sizeof(float) * (size_t)bm->w * (size_t)bm->h);
@@ -55,9 +59,75 @@ void    bump_free(t_bumpmap *bm)
         return ;
     if (bm->hmap)
         free(bm->hmap);
+    free(bm->path);
     free(bm);
 }
 
+t_bumpmap   *bump_acquire(t_bumpmap **cache, const char *path)
+{
+    t_bumpmap   *bm;
+
+    bm = *cache;
+    while (bm && ft_strncmp(bm->path, path, ft_strlen(path) + 1) != 0)
+        bm = bm->next;
+    if (bm)
+    {
+        bm->refs++;
+        return (bm);
+    }
+    bm = bump_load_png(path);
+    if (!bm)
+        return (NULL);
+    bm->path = ft_strdup(path);
+    if (!bm->path)
+    {
+        bump_free(bm);
+        return (NULL);
+    }
+    bm->refs = 1;
+    bm->next = *cache;
+    *cache = bm;
+    return (bm);
+}
+/*
+* Purpose: Get the height map for `path`, decoding the PNG only the first
+* time a scene references it.
+* Notes: Keyed by the path string as written in the scene; a scene with
+* thousands of bump-mapped triangles shares one decoded map.
+*/
+
+void    bump_release(t_bumpmap **cache, t_bumpmap *bm)
+{
+    t_bumpmap   **link;
+
+    if (!bm)
+        return ;
+    if (--bm->refs > 0)
+        return ;
+    link = cache;
+    while (*link && *link != bm)
+        link = &(*link)->next;
+    if (*link)
+        *link = bm->next;
+    bump_free(bm);
+}
+
+void    bump_cache_clear(t_bumpmap **cache)
+{
+    t_bumpmap   *next;
+
+    while (*cache)
+    {
+        next = (*cache)->next;
+        bump_free(*cache);
+        *cache = next;
+    }
+}
+/*
+* Purpose: Drop every cached map regardless of refcount, for references an
+* object could not hand back (parse errors after the map was acquired).
+*/
+
 static float fractf(float x)
 {
     return x - floorf(x);
@@ -2,7 +2,7 @@
 #include "../../include/hit.h"
 #include "../../include/shading.h"
 
-t_vec3	shade_lambert(const t_scene *scene, const t_hit *hit)
+t_vec3	shade_lambert(const t_scene *scene, const t_gbuf_px *px)
 {
 	t_vec3	ambient;
 	t_vec3	l_dir;
@@ -10,20 +10,20 @@ t_vec3	shade_lambert(const t_scene *scene, const t_hit *hit)
 	t_vec3	diff;
 	t_vec3	c;
 
-	if (!hit->ok)
+	if (!px->hit)
 		return v3(0,0,0);
 	ambient = v3_mul(scene->ambient.color, scene->ambient.ratio);
-	if (in_shadow(scene, hit->p, scene->light.pos))
-		return (v3_ctoc(hit->albedo, ambient));
-	l_dir = v3_norm(v3_sub(scene->light.pos, hit->p));
-	ndotl = v3_dot(hit->n, l_dir);
+	if (!px->lit)
+		return (v3_ctoc(px->albedo, ambient));
+	l_dir = v3_norm(v3_sub(scene->lights[0].pos, px->p));
+	ndotl = v3_dot(px->n, l_dir);
 	if (ndotl < 0.0f)
 		ndotl = 0.0f;
-	diff = v3_mul(v3_mul(scene->light.color, scene->light.bright), ndotl);
+	diff = v3_mul(v3_mul(scene->lights[0].color, scene->lights[0].bright), ndotl);
 
 	//specular Blinn-Phong
 	//V = hacia la camara
-	c = v3_add(ambient, v3_ctoc(hit->albedo, diff));
+	c = v3_add(ambient, v3_ctoc(px->albedo, diff));
 	// H = normalize(L + V) con control de longitud
 	return (c);
 }
@@ -7,36 +7,76 @@
 
 
 
-t_vec3	shade_lambert_spec(const t_scene *scene, const t_hit *hit)
+static float	blinn_phong(const t_scene *scene, const t_gbuf_px *px,
+		t_vec3 l_dir)
 {
-	t_vec3	ambient;
-	t_vec3	l_dir;
-	float	ndotl;
-	t_vec3	diff;
-	t_vec3	c;
+	t_vec3	n;
+	t_vec3	v;
+	float	spec_angle;
 
-	if (!hit->ok)
-		return v3(0,0,0);
-	ambient = v3_mul(scene->ambient.color, scene->ambient.ratio);
-	if (in_shadow(scene, hit->p, scene->light.pos))
-		return (v3_ctoc(hit->albedo, ambient));
-	l_dir = v3_norm(v3_sub(scene->light.pos, hit->p));
+	n = v3_norm(px->n);
+	v = v3_norm(v3_sub(scene->camera.pos, px->p)); // direccion hacia la camara
+	//n⋅h=cos(θ), θ = angulo entre la normal y el vector halfway
+	spec_angle = v3_dot(n, v3_norm(v3_add(l_dir, v)));
+	if (spec_angle < 0.0f)
+		spec_angle = 0.0f;
+	return (powf(spec_angle, px->shininess));
+}
+/*
+* Purpose: Blinn-Phong term (N.H)^shininess of one light, without the
+* light's colour.
+*/
+
+t_vec3	light_contrib(const t_scene *scene, const t_gbuf_px *px, int i)
+{
+	const t_light	*l;
+	t_vec3			l_dir;
+	float			ndotl;
+	t_vec3			light;
+	t_vec3			c;
+
+	l = &scene->lights[i];
+	light = v3_mul(l->color, l->bright);
+	l_dir = v3_norm(v3_sub(l->pos, px->p));
 	//how “facing” the surface is toward the light.
-	ndotl = v3_dot(hit->n, l_dir);
+	ndotl = v3_dot(px->n, l_dir);
 	//Negative values mean the light is behind the surface → ignore (no light).
 	if (ndotl < 0.0f)
 		ndotl = 0.0f;
-	diff = v3_mul(v3_mul(scene->light.color, scene->light.bright), ndotl);
-	//t_vec3 specular = specular_blinn_phong(scene, hit, r, scene->objects->u_obj.cy.material->ks);
-	//specular Blinn-Phong
-	//V = hacia la camara
-	//Itotal​=Iambient​+albedo⋅Ilight​⋅max(0,N⋅L)
-	//c = v3_add(ambient, v3_ctoc(hit->albedo, diff));
-	// H = normalize(L + V) con control de longitud
 	//Itotal​=Iambient​+kd​⋅(Ilight​⋅max(0,N⋅L))+ks​⋅(Ilight​⋅max(0,N⋅H)α)
-	c = v3_add(ambient,v3_add(v3_ctoc (hit->albedo, diff), hit->specular));
+	c = v3_ctoc(px->albedo, v3_mul(light, ndotl));
+	if (px->ks > 0.0f)
+		c = v3_add(c, v3_mul(v3_mul(light, blinn_phong(scene, px, l_dir)),
+					px->ks));
 	return (c);
 }
+/*
+* Purpose: Diffuse + specular light that light `i` brings to the texel,
+* assuming nothing blocks it.
+*/
+
+t_vec3	shade_lambert_spec(const t_scene *scene, const t_gbuf_px *px)
+{
+	t_vec3	ambient;
+	t_vec3	sum;
+	int		i;
+
+	if (!px->hit)
+		return v3(0,0,0);
+	ambient = v3_mul(scene->ambient.color, scene->ambient.ratio);
+	if (!px->lit)
+		return (v3_ctoc(px->albedo, ambient));
+	sum = v3(0.0f, 0.0f, 0.0f);
+	i = -1;
+	while (++i < px->lit)
+		sum = v3_add(sum, v3_mul(light_contrib(scene, px, px->light[i]),
+					px->weight[i]));
+	return (v3_add(ambient, sum));
+}
+/*
+* Purpose: Colour of a G-buffer texel: ambient plus the lights its shadow
+* rays reached, each scaled by its sampling weight.
+*/
 
 
 /*
@@ -0,0 +1,207 @@
+#include "../../include/minirt.h"
+#include "../../include/shading_bonus.h"
+
+/* Lights always given a shadow ray once a scene has many of them. */
+#define LIGHT_TOP	2
+
+/*
+* Per-pixel light selection.
+* top, top_est: the LIGHT_TOP strongest lights, strongest first.
+* pool, npool: summed estimate and count of the other lights that remain.
+* albedo: mean albedo of the texel, for the estimates.
+*/
+typedef struct s_light_pick
+{
+	int		top[LIGHT_TOP];
+	float	top_est[LIGHT_TOP];
+	int		ntop;
+	float	pool;
+	int		npool;
+	float	albedo;
+}	t_light_pick;
+
+static float	estimate(const t_scene *scene, const t_gbuf_px *px, int i,
+		float albedo)
+{
+	const t_light	*l;
+	float			ndotl;
+
+	l = &scene->lights[i];
+	ndotl = v3_dot(px->n, v3_norm(v3_sub(l->pos, px->p)));
+	if (ndotl < 0.0f)
+		ndotl = 0.0f;
+	return ((l->color.x + l->color.y + l->color.z) * l->bright
+		* (albedo * ndotl + px->ks));
+}
+/*
+* Purpose: Cheap bound on what light `i` brings to the texel: its diffuse
+* term plus ks, as if the highlight were at its peak. It has no powf, so
+* ranking dozens of lights costs far less than one shadow ray.
+* Notes: Lights have no distance falloff in this renderer, so the surface
+* orientation and the light's brightness are what make a light negligible.
+*/
+
+static void	rank(const t_scene *scene, const t_gbuf_px *px, t_light_pick *pk)
+{
+	float	e;
+	int		i;
+	int		j;
+
+	i = -1;
+	while (++i < scene->light_count)
+	{
+		e = estimate(scene, px, i, pk->albedo);
+		if (e < LIGHT_CULL)
+			continue ;
+		pk->pool += e;
+		pk->npool++;
+		j = pk->ntop;
+		if (j == LIGHT_TOP && e <= pk->top_est[--j])
+			continue ;
+		if (pk->ntop < LIGHT_TOP)
+			pk->ntop++;
+		while (j > 0 && pk->top_est[j - 1] < e)
+		{
+			pk->top[j] = pk->top[j - 1];
+			pk->top_est[j] = pk->top_est[j - 1];
+			j--;
+		}
+		pk->top[j] = i;
+		pk->top_est[j] = e;
+	}
+	j = -1;
+	while (++j < pk->ntop)
+		pk->pool -= pk->top_est[j];
+	pk->npool -= pk->ntop;
+}
+/*
+* Purpose: Cull the lights too weak to show at this point (estimate below
+* LIGHT_CULL), keep the LIGHT_TOP strongest aside and sum the rest.
+*/
+
+static bool	in_pool(const t_light_pick *pk, int i)
+{
+	int	j;
+
+	j = -1;
+	while (++j < pk->ntop)
+		if (pk->top[j] == i)
+			return (false);
+	return (true);
+}
+
+static void	trace(const t_scene *scene, t_gbuf_px *px, int i, float weight)
+{
+	if (in_shadow(scene, px->p, scene->lights[i].pos))
+		return ;
+	px->light[px->lit] = (uint16_t)i;
+	px->weight[px->lit] = weight;
+	px->lit++;
+}
+
+static void	trace_each(const t_scene *scene, t_gbuf_px *px,
+		const t_light_pick *pk)
+{
+	int	i;
+
+	i = -1;
+	while (++i < scene->light_count)
+		if (estimate(scene, px, i, pk->albedo) >= LIGHT_CULL
+			&& in_pool(pk, i))
+			trace(scene, px, i, 1.0f);
+}
+/*
+* Purpose: Trace every pool light, when the budget left covers them all.
+*/
+
+static int	draw(float *acc, float step, int k)
+{
+	int	picks;
+
+	picks = 0;
+	while (*acc > 0.0f && picks < k)
+	{
+		*acc -= step;
+		picks++;
+	}
+	return (picks);
+}
+/*
+* Purpose: How many of the remaining k picks land on the light whose
+* estimate was just added to *acc; one per `step` of it.
+*/
+
+static void	trace_pool(const t_scene *scene, t_gbuf_px *px,
+		const t_light_pick *pk, uint32_t seed)
+{
+	int		k;
+	int		picks;
+	float	step;
+	float	acc;
+	float	e;
+	int		i;
+
+	k = SHADOW_BUDGET - pk->ntop;
+	step = pk->pool / (float)k;
+	seed = seed * 747796405u + 2891336453u;
+	seed = ((seed >> ((seed >> 28) + 4u)) ^ seed) * 277803737u;
+	seed = (seed >> 22) ^ seed;
+	acc = -(float)(seed >> 8) / 16777216.0f * step;
+	i = -1;
+	while (++i < scene->light_count && k > 0)
+	{
+		e = estimate(scene, px, i, pk->albedo);
+		if (e < LIGHT_CULL || !in_pool(pk, i))
+			continue ;
+		acc += e;
+		picks = draw(&acc, step, k);
+		if (picks > 0)
+			trace(scene, px, i, (float)picks * step / e);
+		k -= picks;
+	}
+}
+/*
+* Purpose: Spend the rest of the budget on a pool holding more lights than
+* rays left: k of them are drawn with probability proportional to their
+* estimate (systematic sampling: one random offset, then one pick every
+* pool / k of accumulated estimate), each weighted by 1 / (k * p) so the
+* expected sum is that of every pool light. A light strong enough to
+* be picked several times gets one ray carrying all its picks' weight.
+* Notes: The offset is a hash of the pixel (PCG output permutation), so
+* neighbouring pixels draw unrelated lights and a still image does not
+* flicker from one refinement pass to the next.
+*/
+
+void	light_gather(const t_scene *scene, t_gbuf_px *px, uint32_t seed)
+{
+	t_light_pick	pk;
+	int				i;
+
+	px->lit = 0;
+	if (scene->light_count <= SHADOW_BUDGET)
+	{
+		i = -1;
+		while (++i < scene->light_count)
+			trace(scene, px, i, 1.0f);
+		return ;
+	}
+	ft_bzero(&pk, sizeof(pk));
+	pk.albedo = (px->albedo.x + px->albedo.y + px->albedo.z) / 3.0f;
+	rank(scene, px, &pk);
+	i = -1;
+	while (++i < pk.ntop)
+		trace(scene, px, pk.top[i], 1.0f);
+	if (pk.npool > SHADOW_BUDGET - pk.ntop)
+		trace_pool(scene, px, &pk, seed);
+	else if (pk.npool > 0)
+		trace_each(scene, px, &pk);
+}
+/*
+* Purpose: Trace the shadow rays of a primary hit and record in the texel
+* the lights that reach it, with at most SHADOW_BUDGET rays per pixel.
+* Logic: Up to SHADOW_BUDGET lights every light gets its ray, as with a
+* single light. Beyond that, lights that cannot matter are culled, the
+* LIGHT_TOP strongest are always traced and the remaining rays go to the
+* weak ones by importance sampling, so a scene with dozens of lights costs
+* the same shadow rays as one with four.
+*/
@@ -1,6 +1,7 @@
 #include "../../include/minirt.h"
 #include "../../include/hit.h"
 #include "../../include/shading.h"
+#include "../../include/ray_stats.h"
 
 int	in_shadow(const t_scene *scene, t_vec3 p, t_vec3 l_pos)
 {
@@ -8,16 +9,14 @@ int	in_shadow(const t_scene *scene, t_vec3 p, t_vec3 l_pos)
 	float	max_d;
 	t_vec3	dir;
 	t_ray	rs;
-	t_hit	hit;
 
 	to_l = v3_sub(l_pos, p);
 	max_d = v3_len(to_l);
 	if (max_d <= EPSILON)
 		return (0);
 	dir = v3_div(to_l, max_d);
+	STAT_SHADOW_RAY();
 	rs = ray(v3_add(p, v3_mul(dir, EPSILON)), dir);
-	if (scene_hit(scene, rs, max_d - EPSILON, &hit))
-		return (1);
-	return (0);
+	return (scene_occluded(scene, rs, max_d - EPSILON));
 }
 // Cast a ray from p towards light; ignore self with EPSILON and cap max distance